@@ -0,0 +1,86 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file alloc_counter.hpp
+ * @brief Counters of the heap allocations performed by each thread, for benchmarking.
+ */
+
+#ifndef FCPP_ALLOC_COUNTER_H_
+#define FCPP_ALLOC_COUNTER_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the counters of heap allocations.
+namespace alloc_counter {
+    //! @brief Number of allocations performed by the current thread.
+    inline thread_local size_t allocations = 0;
+
+    //! @brief Number of bytes allocated by the current thread.
+    inline thread_local size_t bytes = 0;
+
+    //! @brief Whether allocations are counted (i.e. `FCPP_COUNT_ALLOCATIONS` has been expanded in the program).
+    inline bool active = false;
+
+    //! @brief Allocates memory, counting the allocation.
+    inline void* allocate(size_t n, size_t align = 0) {
+        ++allocations;
+        bytes += n;
+        if (n == 0) n = 1;
+        void* p = align > alignof(std::max_align_t) ? std::aligned_alloc(align, (n + align - 1) / align * align) : std::malloc(n);
+        if (p == nullptr) throw std::bad_alloc();
+        return p;
+    }
+
+    //! @brief Snapshot of the counters of the current thread, measuring the allocations performed since its creation.
+    class scope {
+      public:
+        //! @brief Number of allocations performed since creation.
+        size_t allocations() const {
+            return alloc_counter::allocations - m_allocations;
+        }
+
+        //! @brief Number of bytes allocated since creation.
+        size_t bytes() const {
+            return alloc_counter::bytes - m_bytes;
+        }
+
+      private:
+        //! @brief Number of allocations at creation.
+        size_t m_allocations = alloc_counter::allocations;
+        //! @brief Number of bytes allocated at creation.
+        size_t m_bytes = alloc_counter::bytes;
+    };
+}
+
+}
+
+/**
+ * @brief Replaces the global allocation functions with counting ones.
+ *
+ * To be expanded once at global scope, in the file containing `main`: the counters
+ * are otherwise never updated.
+ */
+#define FCPP_COUNT_ALLOCATIONS                                                                                                          \
+    void* operator new(std::size_t n) { return fcpp::alloc_counter::allocate(n); }                                                      \
+    void* operator new[](std::size_t n) { return fcpp::alloc_counter::allocate(n); }                                                    \
+    void* operator new(std::size_t n, std::align_val_t a) { return fcpp::alloc_counter::allocate(n, size_t(a)); }                      \
+    void* operator new[](std::size_t n, std::align_val_t a) { return fcpp::alloc_counter::allocate(n, size_t(a)); }                    \
+    void operator delete(void* p) noexcept { std::free(p); }                                                                            \
+    void operator delete[](void* p) noexcept { std::free(p); }                                                                          \
+    void operator delete(void* p, std::size_t) noexcept { std::free(p); }                                                               \
+    void operator delete[](void* p, std::size_t) noexcept { std::free(p); }                                                             \
+    void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }                                                          \
+    void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }                                                        \
+    void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }                                             \
+    void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }                                           \
+    static bool const fcpp_alloc_counter_active = (fcpp::alloc_counter::active = true)
+
+#endif // FCPP_ALLOC_COUNTER_H_
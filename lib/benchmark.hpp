@@ -0,0 +1,336 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file benchmark.hpp
+ * @brief Microbenchmarks of the aggregate building blocks, on synthetic neighbourhoods.
+ */
+
+#ifndef FCPP_BENCHMARK_H_
+#define FCPP_BENCHMARK_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "lib/common/option.hpp"
+#include "lib/component/calculus.hpp"
+
+#include "lib/alloc_counter.hpp"
+#include "lib/bundled_spawn.hpp"
+#include "lib/generals.hpp"
+#include "lib/termination.hpp"
+#include "lib/benchmark_setup.hpp"
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+//! @brief Names of the building blocks measured, by index.
+std::vector<std::string> const bench_names = {
+    "termination_logic<legacy>",
+    "termination_logic<share>",
+    "termination_logic<ispp>",
+    "termination_logic<wispp>",
+    "spawn_profiler<legacy>",
+    "spawn_profiler<share>",
+    "spawn_profiler<ispp>",
+    "spawn_profiler<wispp>",
+    "bundled_spawn<legacy>",
+    "bundled_spawn<share>",
+    "bundled_spawn<ispp>",
+    "bundled_spawn<wispp>",
+    "parent_collection<flat_hash_set>",
+    "parent_collection<dynamic_bloom_filter>",
+    "parent_collection<roaring_set>",
+    "delta_collection<flat_hash_set>",
+    "delta_collection<roaring_set>",
+    "flex_parent",
+    "monotonic_distance",
+    "adjusted_nbr_dist<fast_rand_hood>",
+    "monotonic_distances",
+    "counting_collection<dynamic_bloom_filter>",
+    "adjusted_nbr_dist<rand_hood>"
+};
+
+//! @brief Whether the building block with a given index runs processes.
+inline bool bench_spawns(size_t c) {
+    return c < 12;
+}
+
+//! @brief Measures accumulated by the building blocks (simulations are meant to be run on a single thread).
+struct bench_meter {
+    //! @brief Total nanoseconds spent.
+    double ns = 0;
+    //! @brief Total heap allocations performed.
+    size_t allocations = 0;
+    //! @brief Total device rounds measured.
+    size_t rounds = 0;
+
+    //! @brief The global instance.
+    static bench_meter& instance() {
+        static bench_meter m;
+        return m;
+    }
+};
+
+//! @brief Adds the time and allocations between its construction and destruction to the global measures.
+class bench_timer {
+  public:
+    //! @brief Constructor, given whether measuring is enabled.
+    bench_timer(bool enabled) : m_enabled(enabled), m_start(std::chrono::steady_clock::now()) {}
+
+    //! @brief Destructor, adding up measures.
+    ~bench_timer() {
+        if (not m_enabled) return;
+        bench_meter& m = bench_meter::instance();
+        m.ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+        m.allocations += m_allocs.allocations();
+    }
+
+  private:
+    //! @brief Whether measuring is enabled.
+    bool m_enabled;
+    //! @brief Allocations at construction.
+    alloc_counter::scope m_allocs;
+    //! @brief Time of construction.
+    std::chrono::steady_clock::time_point m_start;
+};
+
+//! @brief Calls a function, measuring it after the warm-up rounds.
+template <typename node_t, typename F>
+auto bench_time(node_t& node, F&& f) {
+    bench_timer t(node.current_time() >= bench_warmup);
+    return f();
+}
+
+
+//! @brief Merges a set into another.
+template <typename S>
+void bench_unite(S& x, S const& y) {
+    x.insert(y.begin(), y.end());
+}
+
+//! @brief Merges a Bloom filter into another.
+template <typename T>
+void bench_unite(dynamic_bloom_filter<T>& x, dynamic_bloom_filter<T> const& y) {
+    x.insert(y);
+}
+
+//! @brief Merges a compressed bitmap into another.
+template <typename T>
+void bench_unite(roaring_set<T>& x, roaring_set<T> const& y) {
+    x.insert(y);
+}
+
+//! @brief The singleton set of a device.
+template <typename S>
+S bench_singleton(device_t uid, S) {
+    return S{uid};
+}
+
+//! @brief The singleton Bloom filter of a device.
+template <typename T>
+dynamic_bloom_filter<T> bench_singleton(device_t uid, dynamic_bloom_filter<T>) {
+    return {bench_bloom_hashes, bench_bloom_bits, {uid}};
+}
+
+
+//! @brief The keys of the processes run by every device (each generated by a device in turn, and targeted at no device).
+FUN std::vector<message> bench_keys(ARGS) {
+    size_t n = node.storage(tags::devices{});
+    size_t p = node.storage(tags::bench_procs{});
+    std::vector<message> keys;
+    for (size_t k = 0; k < p; ++k) keys.emplace_back(device_t(k % n), device_t(n), 0, real_t(k) / p);
+    return keys;
+}
+
+//! @brief Measures the termination logic of every process.
+GEN(T) void termination_bench(ARGS, std::vector<message> const& keys, T) { CODE
+    spawn_deprecated(node, call_point, [&](message const& m){
+        status s = status::internal;
+        bench_time(node, [&](){
+            termination_logic(CALL, s, 2.5, m, T{});
+        });
+        return make_tuple(node.current_time(), s);
+    }, keys);
+}
+//! @brief Export list for termination_bench.
+FUN_EXPORT termination_bench_t = export_list<spawn_t<message, status>, termination_logic_t>;
+
+//! @brief Measures a spawn_profiler call running the given processes.
+GEN(T) void profiler_bench(ARGS, std::vector<message> const& keys, T) { CODE
+    node.storage(tags::proc_data{}).clear();
+    node.storage(tags::proc_data{}).push_back(color::hsva(0, 0, 0.3, 1));
+    bench_time(node, [&](){
+        spawn_profiler(CALL, T{}, [&](message const&){
+            return make_tuple(node.current_time(), status::internal);
+        }, keys, 2.5, -1, 0);
+    });
+}
+//! @brief Export list for profiler_bench.
+FUN_EXPORT profiler_bench_t = export_list<spawn_profiler_t>;
+
+//! @brief Measures a bundled_spawn call running the given processes.
+GEN(T) void bundle_bench(ARGS, std::vector<message> const& keys, T) { CODE
+    node.storage(tags::proc_data{}).clear();
+    node.storage(tags::proc_data{}).push_back(color::hsva(0, 0, 0.3, 1));
+    bench_time(node, [&](){
+        bundled_spawn(CALL, T{}, keys, 2.5, -1, 0);
+    });
+}
+//! @brief Export list for bundle_bench.
+FUN_EXPORT bundle_bench_t = export_list<bundled_spawn_t>;
+
+//! @brief Measures the collection of a set type along a tree.
+GEN(S) void parent_collection_bench(ARGS, device_t parent, S) { CODE
+    S value = bench_singleton(node.uid, S{});
+    bench_time(node, [&](){
+        return parent_collection(CALL, parent, value, [](S x, S const& y){
+            bench_unite(x, y);
+            return x;
+        });
+    });
+}
+//! @brief Export list for parent_collection_bench.
+GEN_EXPORT(S) parent_collection_bench_t = parent_collection_t<S>;
+
+//! @brief Measures the incremental collection of a set type along a tree.
+GEN(S) void delta_collection_bench(ARGS, device_t parent, S) { CODE
+    bench_time(node, [&](){
+        return delta_collection(CALL, parent, node.uid, node.storage(tags::bench_state<S>{}));
+    });
+}
+//! @brief Export list for delta_collection_bench.
+GEN_EXPORT(S) delta_collection_bench_t = delta_collection_t<S>;
+
+//! @brief Measures the collection of Bloom filters along a tree, counting the filters of children.
+FUN void counting_collection_bench(ARGS, device_t parent) { CODE
+    dynamic_bloom_filter<device_t> value = bench_singleton(node.uid, dynamic_bloom_filter<device_t>{});
+    bench_time(node, [&](){
+        return counting_collection(CALL, parent, value, node.storage(tags::bench_state<dynamic_bloom_filter<device_t>>{}));
+    });
+}
+//! @brief Export list for counting_collection_bench.
+FUN_EXPORT counting_collection_bench_t = counting_collection_t<device_t>;
+
+
+//! @brief Main benchmark function, running the building block selected by `bench_case`.
+MAIN() {
+    // import tags for convenience
+    using namespace tags;
+    node.storage(export_log{}).clear();
+    if (delta_exports) codec_round(CALL);
+    if (node.current_time() >= bench_warmup) bench_meter::instance().rounds += 1;
+    std::vector<message> keys = bench_keys(CALL);
+    bool source = node.uid == 0;
+    switch (node.storage(bench_case{})) {
+        case 0:
+            termination_bench(CALL, keys, spherical<legacy>{});
+            break;
+        case 1:
+            termination_bench(CALL, keys, spherical<share>{});
+            break;
+        case 2:
+            termination_bench(CALL, keys, spherical<ispp>{});
+            break;
+        case 3:
+            termination_bench(CALL, keys, spherical<wispp>{});
+            break;
+        case 4:
+            profiler_bench(CALL, keys, spherical<legacy>{});
+            break;
+        case 5:
+            profiler_bench(CALL, keys, spherical<share>{});
+            break;
+        case 6:
+            profiler_bench(CALL, keys, spherical<ispp>{});
+            break;
+        case 7:
+            profiler_bench(CALL, keys, spherical<wispp>{});
+            break;
+        case 8:
+            bundle_bench(CALL, keys, spherical<legacy>{});
+            break;
+        case 9:
+            bundle_bench(CALL, keys, spherical<share>{});
+            break;
+        case 10:
+            bundle_bench(CALL, keys, spherical<ispp>{});
+            break;
+        case 11:
+            bundle_bench(CALL, keys, spherical<wispp>{});
+            break;
+        case 12:
+            parent_collection_bench(CALL, flex_parent(CALL, source, comm), flat_hash_set<device_t>{});
+            break;
+        case 13:
+            parent_collection_bench(CALL, flex_parent(CALL, source, comm), dynamic_bloom_filter<device_t>{});
+            break;
+        case 14:
+            parent_collection_bench(CALL, flex_parent(CALL, source, comm), roaring_set<device_t>{});
+            break;
+        case 15:
+            delta_collection_bench(CALL, flex_parent(CALL, source, comm), flat_hash_set<device_t>{});
+            break;
+        case 16:
+            delta_collection_bench(CALL, flex_parent(CALL, source, comm), roaring_set<device_t>{});
+            break;
+        case 17:
+            bench_time(node, [&](){
+                return flex_parent(CALL, source, comm);
+            });
+            break;
+        case 18:
+            bench_time(node, [&](){
+                return monotonic_distance(CALL, source, node.nbr_dist());
+            });
+            break;
+        case 19:
+            bench_time(node, [&](){
+                return adjusted_nbr_dist(CALL);
+            });
+            break;
+        case 20:
+            bench_time(node, [&](){
+                return monotonic_distances(CALL, source, node.nbr_dist(), node.nbr_lag());
+            });
+            break;
+        case 21:
+            counting_collection_bench(CALL, flex_parent(CALL, source, comm));
+            break;
+        case 22:
+            bench_time(node, [&](){
+                // as adjusted_nbr_dist, drawing every neighbour from the node generator
+                std::weibull_distribution<real_t> d = dist_distr;
+                return cached_nbr_dist(CALL) * rand_hood(CALL, d) + node.storage(tags::speed{}) * comm / period * node.nbr_lag();
+            });
+            break;
+    }
+}
+//! @brief Exports for the main function.
+struct main_t : public export_list<
+    codec_round_t,
+    termination_bench_t,
+    profiler_bench_t,
+    bundle_bench_t,
+    flex_parent_t,
+    monotonic_distance_t,
+    monotonic_distances_t,
+    parent_collection_bench_t<flat_hash_set<device_t>>,
+    parent_collection_bench_t<dynamic_bloom_filter<device_t>>,
+    parent_collection_bench_t<roaring_set<device_t>>,
+    delta_collection_bench_t<flat_hash_set<device_t>>,
+    delta_collection_bench_t<roaring_set<device_t>>,
+    counting_collection_bench_t
+> {};
+
+
+} // coordination
+
+} // fcpp
+
+#endif // FCPP_BENCHMARK_H_
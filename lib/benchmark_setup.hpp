@@ -0,0 +1,120 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file benchmark_setup.hpp
+ * @brief Simulation setup for the microbenchmarks of the aggregate building blocks.
+ */
+
+#ifndef FCPP_BENCHMARK_SETUP_H_
+#define FCPP_BENCHMARK_SETUP_H_
+
+#include "lib/fcpp.hpp"
+#include "lib/generals.hpp"
+#include "lib/roaring_set.hpp"
+#include "lib/simd_bloom.hpp"
+
+#include "lib/common_setup.hpp"
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+namespace tags {
+    //! @brief The index of the building block to be measured.
+    struct bench_case {};
+
+    //! @brief The number of processes run by every device.
+    struct bench_procs {};
+
+    //! @brief The state of the delta collection of a given set type.
+    template <typename S>
+    struct bench_state {};
+}
+
+//! @brief The number of hash functions of benchmarked Bloom filters.
+constexpr size_t bench_bloom_hashes = 2;
+
+//! @brief The number of bits of benchmarked Bloom filters.
+constexpr size_t bench_bloom_bits = 256;
+
+//! @brief The number of rounds before measures start.
+constexpr size_t bench_warmup = 5;
+
+}
+
+//! @brief Namespace for component options.
+namespace option {
+
+//! @brief Storage for processes of a given test.
+template <template<class> class T, typename S>
+using bench_store_t = tuple_store<
+    max_proc<T<S>>,            int,
+    repeat_count<T<S>>,        size_t,
+    max_msg_size<T<S>>,        size_t,
+    tot_msg_size<T<S>>,        size_t,
+    max_proc_size<T<S>>,       size_t,
+    tot_proc<T<S>>,            int,
+    first_delivery_tot<T<S>>,  times_t,
+    delivery_count<T<S>>,      size_t,
+    delivery_log<T<S>>,        delivery_ledger,
+    evict_count<T<S>>,         size_t,
+    budget_log<T<S>>,          budget_ledger
+>;
+
+//! @brief Synchronous rounds, one every period.
+using bench_round_s = sequence::periodic<n<0>, n<period>, i<end_time>>;
+
+//! @brief Initial positions of devices, all within communication range of each other.
+using bench_position_d = distribution::rect<n<0>, n<0>, n<20>, n<comm/2>, n<comm/2>, n<20>>;
+
+//! @brief The general simulation options.
+DECLARE_OPTIONS(list,
+    program<coordination::main>,   // program to be run (refers to MAIN in benchmark.hpp)
+    exports<coordination::main_t>, // export type list (types used in messages)
+    retain<metric::retain<retain_time>>,     // retain time for messages
+    round_schedule<bench_round_s>, // the sequence generator for round events on nodes
+    spawn_schedule<sequence::multiple<i<devices, size_t>, n<0>>>, // the sequence generator of node creation events on the network
+    // the basic contents of the node storage
+    tuple_store<
+        speed,                          double,
+        devices,                        size_t,
+        proc_data,                      std::vector<color>,
+        node_color,                     color,
+        left_color,                     color,
+        right_color,                    color,
+        node_size,                      double,
+        export_log,                     export_meter,
+        export_codec_log,               export_codec,
+        nbr_cache,                      frozen_neighbourhood,
+        bench_case,                     size_t,
+        bench_procs,                    size_t,
+        bench_state<flat_hash_set<device_t>>, coordination::delta_collection_state<flat_hash_set<device_t>>,
+        bench_state<roaring_set<device_t>>,   coordination::delta_collection_state<roaring_set<device_t>>,
+        bench_state<dynamic_bloom_filter<device_t>>, coordination::counting_collection_state<device_t>
+    >,
+    // storage for the processes of every test
+    bench_store_t<spherical, legacy>,
+    bench_store_t<spherical, share>,
+    bench_store_t<spherical, ispp>,
+    bench_store_t<spherical, wispp>,
+    // data initialisation
+    init<
+        x,                  bench_position_d,
+        speed,              n<0>,
+        devices,            i<devices, size_t>,
+        bench_case,         i<bench_case, size_t>,
+        bench_procs,        i<bench_procs, size_t>
+    >,
+    dimension<dim>, // dimensionality of the space
+    connector<connect::fixed<comm, 1, dim>> // connection allowed within a fixed comm range
+);
+
+}
+
+}
+
+#endif // FCPP_BENCHMARK_SETUP_H_
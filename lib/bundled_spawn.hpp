@@ -0,0 +1,278 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file bundled_spawn.hpp
+ * @brief Bundled execution of spherical processes, sharing a single aggregate evaluation and export.
+ *
+ * Instead of a `spawn` running every process on its own (with separate `nbr` calls and trace
+ * entries), a bundle exchanges a single map from the keys of the processes to compact columns
+ * (flags, and distances if needed by the termination logic), and runs the termination logic of
+ * every process on the columns of the neighbours running it.
+ *
+ * A device runs a process if it is in the key set, or some neighbour (including the device
+ * itself) ran it in its last round with internal status; processes with external status are
+ * not exported.
+ */
+
+#ifndef FCPP_BUNDLED_SPAWN_H_
+#define FCPP_BUNDLED_SPAWN_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "lib/common/option.hpp"
+#include "lib/component/calculus.hpp"
+
+#include "lib/field_random.hpp"
+#include "lib/generals.hpp"
+#include "lib/simd_field.hpp"
+#include "lib/termination.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+//! @brief Flags of a bundle column.
+namespace bundle_flag {
+    //! @brief Whether the process is shared with neighbours (internal status).
+    constexpr uint8_t propagate = 1;
+    //! @brief The termination flag of the previous round (legacy termination).
+    constexpr uint8_t old_terminated = 2;
+    //! @brief The termination flag.
+    constexpr uint8_t terminated = 4;
+}
+
+//! @brief Column exported for a process of a bundle (flags only).
+template <bool distances>
+struct bundle_column {
+    //! @brief The flags.
+    uint8_t flags = 0;
+
+    //! @brief Equality operator.
+    bool operator==(bundle_column const& o) const {
+        return flags == o.flags;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & flags;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << flags;
+    }
+};
+
+//! @brief Column exported for a process of a bundle (flags and distances).
+template <>
+struct bundle_column<true> {
+    //! @brief The flags.
+    uint8_t flags = 0;
+    //! @brief Distance from the source in space.
+    real_t ds = INF;
+    //! @brief Distance from the source in time.
+    real_t dt = INF;
+
+    //! @brief Equality operator.
+    bool operator==(bundle_column const& o) const {
+        return flags == o.flags and ds == o.ds and dt == o.dt;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & flags & ds & dt;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << flags << ds << dt;
+    }
+};
+
+//! @brief Whether a termination logic needs distances.
+template <typename T>
+struct bundle_distances : std::false_type {};
+//! @brief Whether a termination logic needs distances (ispp).
+template <template<class> class T>
+struct bundle_distances<T<tags::ispp>> : std::true_type {};
+//! @brief Whether a termination logic needs distances (wispp).
+template <template<class> class T>
+struct bundle_distances<T<tags::wispp>> : std::true_type {};
+
+//! @brief The map exported by a bundle for a termination logic.
+template <typename T>
+using bundle_map = flat_hash_map<message, bundle_column<bundle_distances<T>::value>>;
+
+//! @brief The columns of a process in the neighbourhood, with the relative distances of neighbours.
+template <typename C>
+struct bundle_view {
+    //! @brief The column of the device in its previous round (null if not running the process).
+    C const* self;
+    //! @brief The columns of the neighbours (null for those not running the process).
+    std::vector<C const*> nbrs;
+    //! @brief The distances to neighbours.
+    std::vector<real_t> const* dist;
+    //! @brief The lags of neighbours.
+    std::vector<real_t> const* lag;
+    //! @brief The lag of the device itself.
+    real_t self_lag;
+    //! @brief Key for the random errors on distances.
+    uint64_t seed;
+};
+
+//! @brief Whether all neighbours running the process have a flag set.
+template <typename C>
+bool bundle_all(bundle_view<C> const& v, uint8_t flag) {
+    for (C const* c : v.nbrs) if (c and not (c->flags & flag)) return false;
+    return true;
+}
+
+//! @brief Whether some neighbour running the process has a flag set.
+template <typename C>
+bool bundle_any(bundle_view<C> const& v, uint8_t flag) {
+    for (C const* c : v.nbrs) if (c and (c->flags & flag)) return true;
+    return false;
+}
+
+//! @brief Distances from the source in space and time (as computed by `monotonic_distances` on `adjusted_nbr_dist` and `nbr_lag`).
+template <typename node_t>
+tuple<real_t, real_t> bundle_distances_of(node_t& node, message const& m, bundle_view<bundle_column<true>> const& v, bool source) {
+    if (source) return {0, 0};
+    real_t drift = node.storage(tags::speed{}) * comm / period;
+    real_t ds = (v.self ? v.self->ds : INF) + drift * v.self_lag;
+    real_t dt = (v.self ? v.self->dt : INF) + v.self_lag;
+    uint64_t key = v.seed ^ m.hash();
+    for (size_t j = 0; j < v.nbrs.size(); ++j) if (v.nbrs[j]) {
+        real_t w;
+        field_random::fill(&w, 1, key + j, dist_distr);
+        ds = min(ds, v.nbrs[j]->ds + (*v.dist)[j] * w + drift * (*v.lag)[j]);
+        dt = min(dt, v.nbrs[j]->dt + (*v.lag)[j]);
+    }
+    return {ds, dt};
+}
+
+//! @brief Legacy termination logic on bundle columns (as `termination_logic`).
+template <typename node_t, template<class> class T>
+void bundle_termination(node_t&, status& s, real_t, message const&, bundle_view<bundle_column<false>> const& v, bundle_column<false>& c, T<tags::legacy>) {
+    bool terminating = s == status::terminated_output;
+    bool ot = v.self ? v.self->flags & bundle_flag::terminated : terminating;
+    bool terminated = bundle_any(v, bundle_flag::old_terminated) or ot or terminating;
+    c.flags |= (ot ? bundle_flag::old_terminated : 0) | (terminated ? bundle_flag::terminated : 0);
+    bool exiting = bundle_all(v, bundle_flag::terminated) and terminated;
+    if (exiting) s = status::external_deprecated;
+    else if (terminating) s = status::internal_output;
+}
+
+//! @brief Legacy termination logic updated to use share on bundle columns (as `termination_logic`).
+template <typename node_t, template<class> class T>
+void bundle_termination(node_t&, status& s, real_t, message const&, bundle_view<bundle_column<false>> const& v, bundle_column<false>& c, T<tags::share>) {
+    bool terminating = s == status::terminated_output;
+    bool old = v.self ? v.self->flags & bundle_flag::terminated : terminating;
+    bool terminated = bundle_any(v, bundle_flag::terminated) or old or terminating;
+    c.flags |= terminated ? bundle_flag::terminated : 0;
+    bool exiting = bundle_all(v, bundle_flag::terminated) and terminated;
+    if (exiting) s = status::external_deprecated;
+    else if (terminating) s = status::internal_output;
+}
+
+//! @brief Speed-based termination logic on bundle columns, given whether the device is the source.
+template <typename node_t>
+void bundle_speed_termination(node_t& node, status& s, real_t v, message const& m, bundle_view<bundle_column<true>> const& w, bundle_column<true>& c, bool source) {
+    bool terminating = s == status::terminated_output;
+    bool old = w.self ? w.self->flags & bundle_flag::terminated : terminating;
+    bool terminated = bundle_any(w, bundle_flag::terminated) or old or terminating;
+    c.flags |= terminated ? bundle_flag::terminated : 0;
+    tuple<real_t, real_t> d = bundle_distances_of(node, m, w, source);
+    c.ds = get<0>(d);
+    c.dt = get<1>(d);
+    bool slow = c.ds < v * comm / period * (c.dt - period);
+    if (terminated or slow) {
+        if (s == status::terminated_output) s = status::border_output;
+        if (s == status::internal) s = status::border;
+        if (s == status::internal_output) s = status::border_output;
+    }
+}
+
+//! @brief Novel termination logic on bundle columns (as `termination_logic`).
+template <typename node_t, template<class> class T>
+void bundle_termination(node_t& node, status& s, real_t v, message const& m, bundle_view<bundle_column<true>> const& w, bundle_column<true>& c, T<tags::ispp>) {
+    bundle_speed_termination(node, s, v, m, w, c, m.from == node.uid);
+}
+
+//! @brief Wave-like termination logic on bundle columns (as `termination_logic`).
+template <typename node_t, template<class> class T>
+void bundle_termination(node_t& node, status& s, real_t v, message const& m, bundle_view<bundle_column<true>> const& w, bundle_column<true>& c, T<tags::wispp>) {
+    bundle_speed_termination(node, s, v, m, w, c, m.from == node.uid and w.self == nullptr);
+}
+
+
+//! @brief Runs a bundle of spherical processes for a key set (as `spawn_profiler` on a spherical process), tracking the processes executed.
+GEN(T,S) message_log_type bundled_spawn(ARGS, T, S const& key_set, real_t v, int render, size_t base_overhead) { CODE PROFILE_CODE
+    using map_t = bundle_map<T>;
+    using column_t = typename map_t::mapped_type;
+    message_log_type r;
+    nbr(CALL, map_t{}, [&](field<map_t> x){
+        // the columns of neighbours, with their relative distances
+        static thread_local field_gather g;
+        static thread_local std::vector<real_t> dist, lag;
+        g.domain(node.nbr_uid(), node.uid);
+        g.copy(cached_nbr_dist(CALL), dist, [](real_t d){ return d; });
+        g.copy(node.nbr_lag(), lag, [](real_t d){ return d; });
+        map_t const& prev = self(CALL, x);
+        std::vector<map_t const*> maps;
+        for (device_t id : g.ids()) maps.push_back(&fcpp::details::self(x, id));
+        // the processes to be run
+        std::vector<message> keys;
+        flat_hash_set<message> seen;
+        for (message const& k : key_set) if (seen.insert(k).second) keys.push_back(k);
+        for (auto const& p : prev) if ((p.second.flags & bundle_flag::propagate) and seen.insert(p.first).second) keys.push_back(p.first);
+        for (map_t const* mp : maps) for (auto const& p : *mp)
+            if ((p.second.flags & bundle_flag::propagate) and seen.insert(p.first).second) keys.push_back(p.first);
+        // runs the processes
+        bundle_view<column_t> w{nullptr, std::vector<column_t const*>(maps.size()), &dist, &lag, fcpp::details::self(node.nbr_lag(), node.uid), std::uniform_int_distribution<uint64_t>{}(node.generator())};
+        map_t next;
+        next.reserve(keys.size());
+        for (message const& m : keys) {
+            auto it = prev.find(m);
+            w.self = it == prev.end() ? nullptr : &it->second;
+            for (size_t j = 0; j < maps.size(); ++j) {
+                auto jt = maps[j]->find(m);
+                w.nbrs[j] = jt == maps[j]->end() ? nullptr : &jt->second;
+            }
+            status s = node.uid == m.to ? status::terminated_output : status::internal;
+            column_t c;
+            bundle_termination(node, s, v, m, w, c, T{});
+            real_t key = s == status::external_deprecated ? 0.5 : 1;
+            node.storage(tags::proc_data{}).push_back(color::hsva(m.data * 360, key, key));
+            if (s == status::internal_output or s == status::border_output or s == status::terminated_output) r.emplace(m, node.current_time());
+            if (s == status::external_deprecated) continue;
+            if (s == status::internal or s == status::internal_output) c.flags |= bundle_flag::propagate;
+            node.storage(tags::export_log{}).record(m, serialized_size(m) + serialized_size(c));
+            next.emplace(m, c);
+        }
+        return next;
+    });
+    // compute stats (with a single trace entry and map size for the whole bundle)
+    proc_stats(CALL, r, render, T{}, base_overhead + sizeof(trace_t) + size_prefix);
+    return r;
+}
+//! @brief Export list for bundled_spawn.
+FUN_EXPORT bundled_spawn_t = export_list<bundle_map<tags::spherical<tags::legacy>>, bundle_map<tags::spherical<tags::ispp>>>;
+
+
+} // coordination
+
+} // fcpp
+
+#endif // FCPP_BUNDLED_SPAWN_H_
@@ -54,7 +54,7 @@ color status_color(const devstatus st, const size_t nproc)
     return sc;
 }
 
-FUN bool timeout(ARGS, real_t coeff) { CODE
+FUN bool timeout(ARGS, real_t coeff) { CODE PROFILE_CODE
     int t = counter(CALL);
 
     bool to = t > node.storage(tags::hops{}) * coeff;
@@ -77,7 +77,7 @@ FUN common::option<message> get_disco_message(ARGS, size_t devices) {
 }
 
 //! @brief Simulates sending a file as a sequence of messages to another device.
-FUN common::option<message> send_file_seq(ARGS, fcpp::device_t to, int sz=1) { CODE
+FUN common::option<message> send_file_seq(ARGS, fcpp::device_t to, int sz=1) { CODE PROFILE_CODE
     common::option<message> m;
 
     int cnt = counter(CALL);
@@ -92,11 +92,11 @@ FUN common::option<message> send_file_seq(ARGS, fcpp::device_t to, int sz=1) { C
 }
 
 //! @brief Process that does a spherical broadcast of a message.
-GEN(T) message_log_type spherical_message(ARGS, common::option<message> const& m, T, int render = -1) { CODE
+GEN(T) message_log_type spherical_message(ARGS, common::option<message> const& m, T, int render = -1) { CODE PROFILE_CODE
     message_log_type r = spawn_profiler(CALL, tags::spherical<T>{}, [&](message const& m){
         status s = node.uid == m.to ? status::terminated_output : status::internal;
         return make_tuple(node.current_time(), s);
-    }, m, node.storage(tags::infospeed{}), render, 0, 0);
+    }, m, node.storage(tags::infospeed{}), render, 0);
 
     return r;
 }
@@ -106,7 +106,7 @@ FUN_EXPORT spherical_message_t = export_list<spawn_profiler_t>;
 using parametric_status_t = std::pair<devstatus, message>;
 
 //! @brief Process that does a spherical broadcast of a service request.
-GEN(T) message_log_type spherical_discovery(ARGS, common::option<message> const& m, T, int render = -1) { CODE
+GEN(T) message_log_type spherical_discovery(ARGS, common::option<message> const& m, T, int render = -1) { CODE PROFILE_CODE
     message_log_type r = spawn_profiler(CALL, tags::spherical<T>{}, [&](message const &m) {
         status s = status::internal;
 
@@ -114,14 +114,14 @@ GEN(T) message_log_type spherical_discovery(ARGS, common::option<message> const&
         if (m.svc_type == node.storage(tags::offered_svc{})) s = status::internal_output;
 
         return make_tuple(node.current_time(), s); 
-    }, m, 2.5, render, 0, 0);
+    }, m, 2.5, render, 0);
 
     return r;
 }
 FUN_EXPORT spherical_discovery_t = export_list<spawn_profiler_t>;
 
 //! @brief Sends a message over a tree topology.
-GEN(T,S) key_log_type tree_message(ARGS, common::option<device_t> const& k, parametric_status_t &parst, real_t v, T, device_t parent, S const &below) { CODE
+GEN(T,S) key_log_type tree_message(ARGS, common::option<device_t> const& k, parametric_status_t &parst, real_t v, T, device_t parent, S const &below) { CODE PROFILE_CODE
     devstatus &st = parst.first;
     message &m = parst.second;
 
@@ -197,23 +197,25 @@ GEN(T,S) key_log_type tree_message(ARGS, common::option<device_t> const& k, para
 
             return rp;
         }, k);
-    
+    node.storage(tags::export_log{}).close(node.stack_trace.hash(call_point));
+
     return r;
 }
 //! @brief Export list for spawn_profiler.
 FUN_EXPORT tree_message_t = export_list<spawn_t<device_t, status>, termination_logic_t>;
 
 // TODO ***UNIFY WITH tree_message***
-GEN(T,S) message_log_type tree_message_data(ARGS, common::option<message> const& m, T, device_t parent, S const &below, size_t set_size, int render = -1) { CODE
+GEN(T,S) message_log_type tree_message_data(ARGS, common::option<message> const& m, T, device_t parent, S const &below, size_t tree_size, int render = -1) { CODE PROFILE_CODE
     message_log_type r = spawn_profiler(CALL, tags::tree<T>{}, [&](message const &m) {
             bool source_path = any_hood(CALL, nbr(CALL, parent) == node.uid) or node.uid == m.from;
+            meter_export(CALL, m, parent);
             bool dest_path = below.count(m.to) > 0;
             status s = m.to == node.uid ?  
                     status::terminated_output :
                     source_path or dest_path ? status::internal : status::border;
 
             return make_tuple(node.current_time(), s); 
-        }, m, 0.3, render, set_size + 2*sizeof(trace_t) + sizeof(real_t) + sizeof(device_t), sizeof(trace_t));
+        }, m, 0.3, render, tree_size);
 
     return r;
 }
@@ -221,15 +223,15 @@ GEN(T,S) message_log_type tree_message_data(ARGS, common::option<message> const&
 FUN_EXPORT tree_message_data_t = export_list<spawn_profiler_t>;
 
 #ifdef BLOOM
-//! @brief The type for a set of devices.
-using set_t = bloom_filter<2,128>;
+//! @brief Exports for the collection of routing sets.
+FUN_EXPORT below_collection_t = counting_collection_t<device_t>;
 #else
-//! @brief The type for a set of devices.
-using set_t = std::unordered_set<device_t>;
+//! @brief Exports for the collection of routing sets.
+FUN_EXPORT below_collection_t = delta_collection_t<set_t>;
 #endif
 
 //! @brief Manages behavior of devices with an automaton.
-FUN void device_automaton(ARGS, parametric_status_t &parst) { CODE
+FUN void device_automaton(ARGS, parametric_status_t &parst) { CODE PROFILE_CODE
     // import tags for convenience
     using namespace tags;
 
@@ -246,19 +248,17 @@ FUN void device_automaton(ARGS, parametric_status_t &parst) { CODE
     // spanning tree definition: aggregate computation of parent and below set
     bool is_src = node.uid == 0;
 
-    device_t parent = flex_parent(CALL, is_src, comm);
-    set_t below = parent_collection(CALL, parent, set_t{node.uid}, [](set_t x, set_t const &y)
-                                    {
-                                        #ifdef BLOOM
-                                            x.insert(y);
-                                        #else
-                                            x.insert(y.begin(), y.end());
-                                        #endif
-                                        return x; 
-                                    });
-
-    common::osstream os;
-    os << below;
+    tuple<real_t, device_t> parent_export;
+    device_t parent = flex_parent(CALL, is_src, comm, parent_export);
+#ifdef BLOOM
+    set_t const& below = counting_collection(CALL, parent, set_t{bloom_hashes, bloom_bits, {node.uid}}, node.storage(tags::below_state{}));
+    size_t tree_size = sent_bytes(CALL, below) + sent_bytes(CALL, parent);
+#else
+    set_t const& below = delta_collection(CALL, parent, node.uid, node.storage(tags::below_state{}));
+    size_t tree_size = sizeof(trace_t) + node.storage(tags::below_state{}).export_size();
+    node.storage(tags::export_log{}).wire(tree_size);
+#endif
+    tree_size += sent_bytes(CALL, parent_export);
 
     switch (st) {
     case devstatus::IDLE:
@@ -288,7 +288,7 @@ FUN void device_automaton(ARGS, parametric_status_t &parst) { CODE
     rtm = tree_message(CALL, ktm, parst, 0.3, ispp{}, parent, below);
 
     // another call for data transfer so we can use different termination type if we wish
-    rdt = tree_message_data(CALL, mtd, ispp{}, parent, below, os.size());
+    rdt = tree_message_data(CALL, mtd, ispp{}, parent, below, tree_size);
 
     switch (st) {
     case devstatus::IDLE:
@@ -327,15 +327,17 @@ FUN void device_automaton(ARGS, parametric_status_t &parst) { CODE
         break;
     }
 }
-FUN_EXPORT device_automaton_t = common::export_list<spherical_discovery_t, spherical_message_t, flex_parent_t, real_t, parent_collection_t<set_t>, tree_message_t, tree_message_data_t, timeout_t>;
+FUN_EXPORT device_automaton_t = common::export_list<spherical_discovery_t, spherical_message_t, flex_parent_t, real_t, below_collection_t, tree_message_t, tree_message_data_t, timeout_t>;
 
 //! @brief Main case study function.
-MAIN() {
+MAIN() { PROFILE_ROUND
     // import tags for convenience
     using namespace tags;
-    // random walk
+    // stats on the messages actually sent
+    wire_stats(CALL);
+    // random walk (skipped under a static topology)
     size_t l = node.storage(side{});
-    rectangle_walk(CALL, make_vec(0, 0, 20), make_vec(l, l, 20), node.storage(speed{}) * comm / period, 1);
+    if (node.storage(speed{}) > 0) rectangle_walk(CALL, make_vec(0, 0, 20), make_vec(l, l, 20), node.storage(speed{}) * comm / period, 1);
 
     old(CALL, parametric_status_t{devstatus::IDLE, message{}}, [&](parametric_status_t parst) {
         // basic node rendering
@@ -365,7 +367,7 @@ MAIN() {
         return parst; });
 }
 //! @brief Exports for the main function.
-struct main_t : public export_list<rectangle_walk_t<3>, std::pair<devstatus, message>, device_automaton_t>
+struct main_t : public export_list<wire_stats_t, rectangle_walk_t<3>, std::pair<devstatus, message>, device_automaton_t>
 {
 };
 
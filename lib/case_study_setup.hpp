@@ -10,6 +10,8 @@
 
 #include "lib/fcpp.hpp"
 #include "lib/generals.hpp"
+#include "lib/roaring_set.hpp"
+#include "lib/simd_bloom.hpp"
 
 #include "lib/common_setup.hpp"
 
@@ -28,6 +30,21 @@ enum devstatus
     SERVED, // being served
     SERVING // serving
 };
+
+#ifdef BLOOM
+//! @brief The number of hash functions of routing sets.
+constexpr size_t bloom_hashes = 2;
+//! @brief The number of bits of routing sets.
+constexpr size_t bloom_bits = 128;
+//! @brief The type for a set of devices.
+using set_t = dynamic_bloom_filter<device_t>;
+#elif defined(ROARING)
+//! @brief The type for a set of devices.
+using set_t = roaring_set<device_t>;
+#else
+//! @brief The type for a set of devices.
+using set_t = flat_hash_set<device_t>;
+#endif
 }
 
 //! @brief Namespace for component options.
@@ -40,9 +57,13 @@ using test_store_t = tuple_store<
     repeat_count<T<S>>,        size_t,
     max_msg_size<T<S>>,        size_t,
     tot_msg_size<T<S>>,        size_t,
+    max_proc_size<T<S>>,       size_t,
     tot_proc<T<S>>,            int,
     first_delivery_tot<T<S>>,  times_t,
-    delivery_count<T<S>>,      size_t
+    delivery_count<T<S>>,      size_t,
+    delivery_log<T<S>>,        delivery_ledger,
+    evict_count<T<S>>,         size_t,
+    budget_log<T<S>>,          budget_ledger
 >;
 
 template <int s, typename T = dev_status>
@@ -58,11 +79,12 @@ using plot_t = plot::split<plot::time,
 
 //! @brief The general simulation options.
 DECLARE_OPTIONS(list,
-    parallel<false>,     // no multithreading on node rounds
-    synchronised<false>, // optimise for asynchronous networks
+    parallel<parallel_rounds>,     // multithreading on node rounds (with the PARALLEL flag)
+    synchronised<parallel_rounds>, // rounds aligned to time slots are executed together
     program<coordination::main>,   // program to be run (refers to MAIN in process_management.hpp)
     exports<coordination::main_t>, // export type list (types used in messages)
-    retain<metric::retain<2>>, // retain time for messages
+    message_size<true>,            // computes the size of messages sent
+    retain<metric::retain<retain_time>>, // retain time for messages
     round_schedule<round_s>, // the sequence generator for round events on nodes
     log_schedule<log_s>, // the sequence generator for log events on the network
     spawn_schedule<sequence::multiple<i<devices, size_t>, n<0>>>, // the sequence generator of node creation events on the network
@@ -80,6 +102,18 @@ DECLARE_OPTIONS(list,
         right_color,                    color,
         node_size,                      double,
         node_shape,                     shape,
+        export_log,                     export_meter,
+        export_codec_log,               export_codec,
+        nbr_cache,                      frozen_neighbourhood,
+        max_wire_size,                  size_t,
+        tot_wire_size,                  size_t,
+        max_unmetered_size,             size_t,
+        tot_unmetered_size,             size_t,
+#ifdef BLOOM
+        below_state,                    coordination::counting_collection_state<device_t>,
+#else
+        below_state,                    coordination::delta_collection_state<coordination::set_t>,
+#endif
         num_svc_types,                  size_t,
         offered_svc,                    size_t,
         svc_rank,                       real_t,
@@ -91,6 +125,10 @@ DECLARE_OPTIONS(list,
     >,
     // the basic tags and corresponding aggregators to be logged
     aggregators<
+        max_wire_size,      aggregator::max<size_t>,
+        tot_wire_size,      aggregator::sum<size_t>,
+        max_unmetered_size, aggregator::max<size_t>,
+        tot_unmetered_size, aggregator::sum<size_t>,
         sent_count,         aggregator::sum<size_t>,
         dev_status,         aggregator::combine<status_aggregator<coordination::devstatus::SERVING, double>,
                                                 status_aggregator<coordination::devstatus::SERVED, double>,
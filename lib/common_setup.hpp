@@ -17,6 +17,16 @@
  */
 namespace fcpp {
 
+//! @brief Co-simulation runs Bloom filter tree tests together with exact ones (so BLOOM is redundant, and trees are required).
+#ifdef COSIM
+#ifdef BLOOM
+#error "COSIM cannot be combined with BLOOM"
+#endif
+#ifdef NOTREE
+#error "COSIM cannot be combined with NOTREE"
+#endif
+#endif
+
 //! @cond INTERNAL
 namespace coordination {
     struct main;   // forward declaration of main function
@@ -43,6 +53,77 @@ constexpr double timeout_coeff = 2;
 //! @brief Multiplier of hops for stabilization delay (in rounds).
 constexpr double stabilize_coeff = 1;
 
+//! @brief Time after which delivered messages are forgotten (further deliveries then count as first ones).
+constexpr times_t delivery_ttl = std::numeric_limits<times_t>::infinity();
+
+//! @brief Whether node rounds are executed in parallel (enabled by the PARALLEL flag).
+#ifdef PARALLEL
+constexpr bool parallel_rounds = true;
+#else
+constexpr bool parallel_rounds = false;
+#endif
+
+/**
+ * @brief Whether round timings are aligned to time slots (always with parallel rounds, or with the SLOTS flag).
+ *
+ * Aligning timings changes the schedule of rounds, so that results with PARALLEL differ from those
+ * of serial runs, unless these are aligned as well through SLOTS (e.g. for measuring speedups).
+ */
+#if defined(PARALLEL) || defined(SLOTS)
+constexpr bool slotted_rounds = true;
+#else
+constexpr bool slotted_rounds = false;
+#endif
+
+//! @brief Number of time slots per period to which rounds are aligned.
+constexpr intmax_t round_slots = 64;
+
+//! @brief Whether idle devices back off their round rate (enabled by the ADAPTIVE flag).
+#ifdef ADAPTIVE
+constexpr bool adaptive_rounds = true;
+#else
+constexpr bool adaptive_rounds = false;
+#endif
+
+/**
+ * @brief Maximum multiplier of round intervals for idle devices.
+ *
+ * A process reaching an idle device waits at most `max_backoff` round intervals before being run,
+ * so that the delay of a delivery along `h` hops grows by at most `h * (max_backoff - 1)` intervals.
+ */
+constexpr size_t max_backoff = 4;
+
+/**
+ * @brief Time after which the exports of a silent neighbour are discarded.
+ *
+ * It spans two round intervals, even when backed off, so that idle devices are not dropped
+ * by their neighbours between rounds.
+ */
+constexpr intmax_t retain_time = 2 * period * (adaptive_rounds ? max_backoff : 1);
+static_assert(max_backoff * period < retain_time or not adaptive_rounds, "backed off rounds exceed the retain time");
+
+//! @brief Whether exports are delta encoded, sending only the values changed since acknowledged (enabled by the DELTA flag).
+#ifdef DELTA
+constexpr bool delta_exports = true;
+#else
+constexpr bool delta_exports = false;
+#endif
+
+//! @brief Number of rounds between full exports, when delta encoded.
+constexpr size_t keyframe_period = 10;
+
+//! @brief Budget of processes run by every node (bounded in number by the BUDGET flag, e.g. `-DBUDGET=8`).
+#ifdef BUDGET
+process_budget const proc_budget{BUDGET};
+#else
+process_budget const proc_budget{};
+#endif
+
+//! @brief Bundles of spherical processes are neither bounded by a budget nor delta encoded.
+#if defined(BUNDLE) && (defined(BUDGET) || defined(DELTA))
+#error "BUNDLE cannot be combined with BUDGET or DELTA"
+#endif
+
 //! @brief Number of service types.
 const size_t max_svc_id = 100;
 
@@ -118,10 +199,50 @@ using nu = distribution::interval_n<double, min, max>;
 template <typename T, typename R = double>
 using i = distribution::constant_i<R, T>;
 
-//! @brief The randomised sequence of rounds for every node (about one every second, with 10% variance).
+//! @brief Rounds the values of a distribution to positive multiples of a given quantum.
+template <typename D, intmax_t num, intmax_t den = 1>
+class quantize : public D {
+  public:
+    //! @brief The type of the generated values.
+    using type = typename D::type;
+
+    //! @brief Inherited constructors.
+    using D::D;
+
+    //! @brief Generates a quantized value.
+    template <typename G>
+    type operator()(G&& g) {
+        return align(D::operator()(std::forward<G>(g)));
+    }
+
+    //! @brief Generates a quantized value (const overload).
+    template <typename G>
+    type operator()(G&& g) const {
+        return align(D::operator()(std::forward<G>(g)));
+    }
+
+  private:
+    //! @brief Aligns a value to the closest positive multiple of the quantum.
+    static type align(type x) {
+        constexpr type q = type(num) / den;
+        return std::max(q, std::round(x / q) * q);
+    }
+};
+
+//! @brief Distribution of round timings, aligned to time slots if required (see `slotted_rounds`).
+template <typename D>
+using round_d = std::conditional_t<slotted_rounds, quantize<D, period, round_slots>, D>;
+
+/**
+ * @brief The randomised sequence of rounds for every node (about one every second, with 10% variance).
+ *
+ * With parallel rounds, timings are aligned to time slots, so that the rounds of different nodes
+ * falling in the same slot are scheduled together and executed concurrently. This is a different
+ * schedule from the unaligned one, giving different (although statistically similar) results.
+ */
 using round_s = sequence::periodic<
-    distribution::interval_n<times_t, 0, 1>,
-    distribution::weibull<i<tavg>, functor::mul<i<tvar>, i<tavg>>>,
+    round_d<distribution::interval_n<times_t, 0, 1>>,
+    round_d<distribution::weibull<i<tavg>, functor::mul<i<tvar>, i<tavg>>>>,
     functor::add<i<end_time>, n<5*period>>
 >;
 
@@ -0,0 +1,279 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file export_codec.hpp
+ * @brief Delta encoding of exports, sending only the values changed since the last export acknowledged by neighbours.
+ *
+ * Every value exported is identified by a key (its trace and process), and tracked with a hash of
+ * its content and the version (round) in which it last changed. Nodes exchange the version of their
+ * export, and echo back the last version of every neighbour they hold in full: a value is sent only
+ * if it changed after the oldest version echoed by the current neighbours. New neighbours thus
+ * receive full exports, a delta is applied only on top of the version it is based on, and every
+ * `keyframe` rounds the export is sent in full anyway, for robustness to lost messages.
+ */
+
+#ifndef FCPP_EXPORT_CODEC_H_
+#define FCPP_EXPORT_CODEC_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lib/settings.hpp"
+
+#include "lib/flat_hash.hpp"
+#include "lib/size_stream.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Output archive computing a hash of the serialisation of objects, without producing their bytes.
+ *
+ * It supports the same values as `size_stream`, so that equal exports produce equal hashes.
+ */
+class hash_stream {
+  public:
+    //! @brief The hash of the values so far.
+    uint64_t hash() const {
+        return m_hash;
+    }
+
+    //! @brief Hashes a value.
+    template <typename T>
+    hash_stream& operator<<(T const& x) {
+        mix(x, details::rank<2>{});
+        return *this;
+    }
+
+    //! @brief Hashes a value (for `serialize` members).
+    template <typename T>
+    hash_stream& operator&(T const& x) {
+        return *this << x;
+    }
+
+  private:
+    //! @brief Arithmetic and enumeration values.
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value or std::is_enum<T>::value> mix(T const& x, details::rank<2>) {
+        uint64_t b = 0;
+        std::memcpy(&b, &x, std::min(sizeof(T), sizeof(uint64_t)));
+        m_hash = hash_mix(m_hash ^ b);
+    }
+
+    //! @brief Objects with a `serialize` member.
+    template <typename T>
+    auto mix(T const& x, details::rank<1>) -> decltype(x.serialize(*this), void()) {
+        x.serialize(*this);
+    }
+
+    //! @brief Containers.
+    template <typename T>
+    auto mix(T const& x, details::rank<0>) -> decltype(std::begin(x), std::end(x), void()) {
+        size_t n = 0;
+        for (auto const& y : x) {
+            *this << y;
+            ++n;
+        }
+        *this << n;
+    }
+
+    //! @brief Pairs.
+    template <typename T, typename U>
+    void mix(std::pair<T, U> const& x, details::rank<0>) {
+        *this << x.first << x.second;
+    }
+
+    //! @brief Tuples.
+    template <typename... Ts>
+    void mix(std::tuple<Ts...> const& x, details::rank<0>) {
+        std::apply([this](auto const&... y){
+            [[maybe_unused]] int c[] = {0, ((*this << y), 0)...};
+        }, x);
+    }
+
+    //! @brief The hash of the values so far.
+    uint64_t m_hash = 0;
+};
+
+
+//! @brief The hash of the serialisation of a value.
+template <typename T>
+uint64_t serialized_hash(T const& x) {
+    hash_stream s;
+    s << x;
+    return s.hash();
+}
+
+
+//! @brief Versions exchanged between export codecs, acknowledging the exports received.
+struct export_versions {
+    //! @brief The version of the export of the sender.
+    size_t version = 0;
+    //! @brief The version the export of the sender is based on (zero for a full export).
+    size_t base = 0;
+    //! @brief The last versions of the exports of neighbours held in full by the sender.
+    std::vector<std::pair<device_t, size_t>> acks;
+
+    //! @brief The version of the export of a given neighbour held by the sender (zero if none).
+    size_t ack(device_t id) const {
+        for (auto const& a : acks) if (a.first == id) return a.second;
+        return 0;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & version & base & acks;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << version << base << acks;
+    }
+};
+
+
+/**
+ * @brief Delta encoder of the exports of a node, updated in place.
+ *
+ * At the start of every round, `receive` registers the versions exchanged by every neighbour, and
+ * `round` computes the base version for the round, returning the versions to be exchanged.
+ * Then `encode` returns the bytes actually sent for every value exported.
+ */
+class export_codec {
+  public:
+    //! @brief Bytes of the mask signalling which values of a group are sent.
+    static constexpr size_t mask_bytes = 1;
+
+    //! @brief Registers the versions received from a neighbour (other than the node itself).
+    void receive(device_t id, export_versions const& v, device_t uid) {
+        // a delta is applied only if based on the version held of the neighbour
+        auto it = m_held.find(id);
+        size_t h = it == m_held.end() ? 0 : it->second;
+        if (v.base <= h) h = v.version;
+        if (h > 0) m_next.emplace_back(id, h);
+        m_acks.push_back(v.ack(uid));
+    }
+
+    //! @brief Starts a new round given the keyframe period (zero for none), returning the versions to be exchanged.
+    export_versions round(size_t keyframe) {
+        ++m_version;
+        // the oldest version held by the neighbours (zero for new ones)
+        m_base = m_version - 1;
+        for (size_t a : m_acks) m_base = std::min(m_base, a);
+        if (keyframe > 0 and m_version % keyframe == 0) m_base = 0;
+        m_acks.clear();
+        // the versions held of neighbours
+        m_held.clear();
+        for (auto const& p : m_next) m_held[p.first] = p.second;
+        // forgets the values not exported in the last round
+        for (auto it = m_values.begin(); it != m_values.end(); ) {
+            auto x = it++;
+            if (x->second.seen + 1 < m_version) m_values.erase(x);
+        }
+        export_versions v;
+        v.version = m_version;
+        v.base = m_base;
+        v.acks = std::move(m_next);
+        m_next.clear();
+        m_versions = sizeof(trace_t) + serialized_size(v);
+        return v;
+    }
+
+    //! @brief The key of a value exported through a trace, for a given process (or other discriminator).
+    static uint64_t key(trace_t t, uint64_t h) {
+        return hash_mix(uint64_t(t) ^ hash_mix(h + 0x9e3779b97f4a7c15ULL));
+    }
+
+    //! @brief Bytes sent for a value of a given hash and full size, tracking its changes.
+    size_t encode(uint64_t key, uint64_t hash, size_t bytes) {
+        entry& e = m_values[key];
+        if (e.seen == 0 or e.hash != hash) {
+            e.hash = hash;
+            e.changed = m_version;
+        }
+        e.seen = m_version;
+        m_full += bytes;
+        size_t r = e.changed > m_base ? bytes : 0;
+        m_sent += r;
+        return r;
+    }
+
+    //! @brief Bytes sent for a value, tracking its changes.
+    template <typename T>
+    size_t encode(uint64_t key, T const& x) {
+        return encode(key, serialized_hash(x), sizeof(trace_t) + serialized_size(x));
+    }
+
+    //! @brief Whether the current round sends a full export.
+    bool keyframe() const {
+        return m_base == 0;
+    }
+
+    //! @brief Bytes of the versions exchanged in the current round.
+    size_t versions_bytes() const {
+        return m_versions;
+    }
+
+    //! @brief Total bytes of the values encoded, as they would be sent in full.
+    size_t full_bytes() const {
+        return m_full;
+    }
+
+    //! @brief Total bytes of the values encoded, as actually sent.
+    size_t sent_bytes() const {
+        return m_sent;
+    }
+
+  private:
+    //! @brief Data about a value.
+    struct entry {
+        //! @brief The hash of the value.
+        uint64_t hash = 0;
+        //! @brief The version in which the value last changed.
+        size_t changed = 0;
+        //! @brief The last version in which the value was exported (zero if never).
+        size_t seen = 0;
+    };
+
+    //! @brief The current version (the number of the round).
+    size_t m_version = 0;
+    //! @brief Values changed after this version are sent.
+    size_t m_base = 0;
+    //! @brief The versions of the export of the node held by the neighbours, as echoed in the current round.
+    std::vector<size_t> m_acks;
+    //! @brief The versions of the exports of neighbours held in full, as of the last round.
+    flat_hash_map<device_t, size_t> m_held;
+    //! @brief The versions of the exports of neighbours held in full, as of the current round.
+    std::vector<std::pair<device_t, size_t>> m_next;
+    //! @brief The values exported in the current and last round.
+    flat_hash_map<uint64_t, entry> m_values;
+    //! @brief Bytes of the versions exchanged in the current round.
+    size_t m_versions = 0;
+    //! @brief Total bytes of the values encoded, as they would be sent in full.
+    size_t m_full = 0;
+    //! @brief Total bytes of the values encoded, as actually sent.
+    size_t m_sent = 0;
+};
+
+//! @brief Printing an export codec.
+inline std::ostream& operator<<(std::ostream& o, export_codec const& c) {
+    return o << c.sent_bytes() << "/" << c.full_bytes() << " bytes sent";
+}
+
+
+} // fcpp
+
+#endif // FCPP_EXPORT_CODEC_H_
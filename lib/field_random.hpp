@@ -0,0 +1,351 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file field_random.hpp
+ * @brief Counter-based generation of arrays of random reals, through inverse cumulative distribution functions.
+ *
+ * The i-th number of an array only depends on a key and on i, so that arrays are filled by loops
+ * without state carried across iterations, and without advancing the generator of the node.
+ */
+
+#ifndef FCPP_FIELD_RANDOM_H_
+#define FCPP_FIELD_RANDOM_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "lib/flat_hash.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing the counter-based generation of random arrays.
+namespace field_random {
+    //! @brief Increment of the counters (golden ratio).
+    constexpr uint64_t step = 0x9e3779b97f4a7c15ULL;
+
+    //! @cond INTERNAL
+    namespace details {
+        //! @brief Reinterprets the bits of a value as another type.
+        template <typename T, typename U>
+        T bit_cast(U x) {
+            T y;
+            std::memcpy(&y, &x, sizeof(T));
+            return y;
+        }
+
+        //! @brief Operations on lanes of a single real (or 64-bit integer), for loop tails and other targets.
+        struct scalar_lanes {
+            using real = double;
+            using word = uint64_t;
+            static constexpr size_t width = 1;
+            static real load(double const* p) { return *p; }
+            static void store(double* p, real x) { *p = x; }
+            static real set(double x) { return x; }
+            static word set_word(uint64_t x) { return x; }
+            static word counters(uint64_t key) { return key; }
+            static real add(real a, real b) { return a + b; }
+            static real sub(real a, real b) { return a - b; }
+            static real mul(real a, real b) { return a * b; }
+            static real div(real a, real b) { return a / b; }
+            static real min(real a, real b) { return b < a ? b : a; }
+            static real max(real a, real b) { return a < b ? b : a; }
+            static real greater(real a, real b) { return bit_cast<real>(a > b ? ~uint64_t(0) : 0); }
+            static real bit_and(real a, real b) { return bit_cast<real>(bit_cast<word>(a) & bit_cast<word>(b)); }
+            static real bit_or(real a, real b) { return bit_cast<real>(bit_cast<word>(a) | bit_cast<word>(b)); }
+            static real bit_andnot(real a, real b) { return bit_cast<real>(~bit_cast<word>(a) & bit_cast<word>(b)); }
+            static real as_real(word x) { return bit_cast<real>(x); }
+            static word as_word(real x) { return bit_cast<word>(x); }
+            static word add(word a, word b) { return a + b; }
+            static word sub(word a, word b) { return a - b; }
+            static word mul(word a, word b) { return a * b; }
+            static word bit_xor(word a, word b) { return a ^ b; }
+            static word bit_and(word a, word b) { return a & b; }
+            static word bit_or(word a, word b) { return a | b; }
+            static word shift_right(word a, int k) { return a >> k; }
+            static word shift_left(word a, int k) { return a << k; }
+        };
+
+#if defined(__AVX2__)
+        //! @brief Operations on lanes of four reals (or 64-bit integers) in AVX2 registers.
+        struct vector_lanes {
+            using real = __m256d;
+            using word = __m256i;
+            static constexpr size_t width = 4;
+            static real load(double const* p) { return _mm256_loadu_pd(p); }
+            static void store(double* p, real x) { _mm256_storeu_pd(p, x); }
+            static real set(double x) { return _mm256_set1_pd(x); }
+            static word set_word(uint64_t x) { return _mm256_set1_epi64x(x); }
+            static word counters(uint64_t key) { return _mm256_set_epi64x(key + 3*step, key + 2*step, key + step, key); }
+            static real add(real a, real b) { return _mm256_add_pd(a, b); }
+            static real sub(real a, real b) { return _mm256_sub_pd(a, b); }
+            static real mul(real a, real b) { return _mm256_mul_pd(a, b); }
+            static real div(real a, real b) { return _mm256_div_pd(a, b); }
+            static real min(real a, real b) { return _mm256_min_pd(a, b); }
+            static real max(real a, real b) { return _mm256_max_pd(a, b); }
+            static real greater(real a, real b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+            static real bit_and(real a, real b) { return _mm256_and_pd(a, b); }
+            static real bit_or(real a, real b) { return _mm256_or_pd(a, b); }
+            static real bit_andnot(real a, real b) { return _mm256_andnot_pd(a, b); }
+            static real as_real(word x) { return _mm256_castsi256_pd(x); }
+            static word as_word(real x) { return _mm256_castpd_si256(x); }
+            static word add(word a, word b) { return _mm256_add_epi64(a, b); }
+            static word sub(word a, word b) { return _mm256_sub_epi64(a, b); }
+            static word mul(word a, word b) {
+                // low 64 bits of the products, from 32-bit multiplications
+                word lo = _mm256_mul_epu32(a, b);
+                word mid = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+                return _mm256_add_epi64(lo, _mm256_slli_epi64(mid, 32));
+            }
+            static word bit_xor(word a, word b) { return _mm256_xor_si256(a, b); }
+            static word bit_and(word a, word b) { return _mm256_and_si256(a, b); }
+            static word bit_or(word a, word b) { return _mm256_or_si256(a, b); }
+            static word shift_right(word a, int k) { return _mm256_srli_epi64(a, k); }
+            static word shift_left(word a, int k) { return _mm256_slli_epi64(a, k); }
+        };
+#elif defined(__SSE2__)
+        //! @brief Operations on lanes of two reals (or 64-bit integers) in SSE2 registers.
+        struct vector_lanes {
+            using real = __m128d;
+            using word = __m128i;
+            static constexpr size_t width = 2;
+            static real load(double const* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, real x) { _mm_storeu_pd(p, x); }
+            static real set(double x) { return _mm_set1_pd(x); }
+            static word set_word(uint64_t x) { return _mm_set1_epi64x(x); }
+            static word counters(uint64_t key) { return _mm_set_epi64x(key + step, key); }
+            static real add(real a, real b) { return _mm_add_pd(a, b); }
+            static real sub(real a, real b) { return _mm_sub_pd(a, b); }
+            static real mul(real a, real b) { return _mm_mul_pd(a, b); }
+            static real div(real a, real b) { return _mm_div_pd(a, b); }
+            static real min(real a, real b) { return _mm_min_pd(a, b); }
+            static real max(real a, real b) { return _mm_max_pd(a, b); }
+            static real greater(real a, real b) { return _mm_cmpgt_pd(a, b); }
+            static real bit_and(real a, real b) { return _mm_and_pd(a, b); }
+            static real bit_or(real a, real b) { return _mm_or_pd(a, b); }
+            static real bit_andnot(real a, real b) { return _mm_andnot_pd(a, b); }
+            static real as_real(word x) { return _mm_castsi128_pd(x); }
+            static word as_word(real x) { return _mm_castpd_si128(x); }
+            static word add(word a, word b) { return _mm_add_epi64(a, b); }
+            static word sub(word a, word b) { return _mm_sub_epi64(a, b); }
+            static word mul(word a, word b) {
+                // low 64 bits of the products, from 32-bit multiplications
+                word lo = _mm_mul_epu32(a, b);
+                word mid = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+                return _mm_add_epi64(lo, _mm_slli_epi64(mid, 32));
+            }
+            static word bit_xor(word a, word b) { return _mm_xor_si128(a, b); }
+            static word bit_and(word a, word b) { return _mm_and_si128(a, b); }
+            static word bit_or(word a, word b) { return _mm_or_si128(a, b); }
+            static word shift_right(word a, int k) { return _mm_srli_epi64(a, k); }
+            static word shift_left(word a, int k) { return _mm_slli_epi64(a, k); }
+        };
+#endif
+
+        //! @brief Bits of 2^52, whose mantissa holds integers up to 2^52 exactly.
+        constexpr uint64_t two52_bits = 0x4330000000000000ULL;
+
+        //! @brief Integers below 2^52 converted to reals.
+        template <typename V>
+        typename V::real to_real(typename V::word x) {
+            return V::sub(V::as_real(V::bit_or(x, V::set_word(two52_bits))), V::set(0x1.0p52));
+        }
+
+        //! @brief Uniform reals in (0,1] from counters (as `(hash_mix(c) >> 11) + 1` times 2^-53).
+        template <typename V>
+        typename V::real unit(typename V::word c) {
+            c = V::bit_xor(c, V::shift_right(c, 33));
+            c = V::mul(c, V::set_word(0xff51afd7ed558ccdULL));
+            c = V::bit_xor(c, V::shift_right(c, 33));
+            c = V::mul(c, V::set_word(0xc4ceb9fe1a85ec53ULL));
+            c = V::bit_xor(c, V::shift_right(c, 33));
+            c = V::shift_right(c, 11);
+            // the 53 bits are converted in two parts, exactly
+            typename V::real lo = to_real<V>(V::bit_and(c, V::set_word((uint64_t(1) << 52) - 1)));
+            typename V::real hi = to_real<V>(V::shift_right(c, 52));
+            return V::mul(V::add(V::add(lo, V::mul(hi, V::set(0x1.0p52))), V::set(1)), V::set(0x1.0p-53));
+        }
+
+        //! @brief Natural logarithm of positive normal reals (as in fdlibm, within one ulp).
+        template <typename V>
+        typename V::real log(typename V::real x) {
+            using R = typename V::real;
+            typename V::word b = V::as_word(x);
+            // x = m * 2^e with m in [sqrt(2)/2, sqrt(2))
+            R e = V::sub(to_real<V>(V::shift_right(b, 52)), V::set(1023));
+            R m = V::as_real(V::bit_or(V::bit_and(b, V::set_word(0x000fffffffffffffULL)), V::set_word(0x3ff0000000000000ULL)));
+            R high = V::greater(m, V::set(1.41421356237309504880));
+            m = V::mul(m, V::bit_or(V::bit_and(high, V::set(0.5)), V::bit_andnot(high, V::set(1))));
+            e = V::add(e, V::bit_and(high, V::set(1)));
+            R f = V::sub(m, V::set(1));
+            R s = V::div(f, V::add(V::set(2), f));
+            R z = V::mul(s, s);
+            R r = V::set(1.479819860511658591e-01);
+            r = V::add(V::mul(r, z), V::set(1.531383769920937332e-01));
+            r = V::add(V::mul(r, z), V::set(1.818357216161805012e-01));
+            r = V::add(V::mul(r, z), V::set(2.222219843214978396e-01));
+            r = V::add(V::mul(r, z), V::set(2.857142874366239149e-01));
+            r = V::add(V::mul(r, z), V::set(3.999999999940941908e-01));
+            r = V::add(V::mul(r, z), V::set(6.666666666666735130e-01));
+            r = V::mul(r, z);
+            R hfsq = V::mul(V::set(0.5), V::mul(f, f));
+            R lo = V::add(V::mul(s, V::add(hfsq, r)), V::mul(e, V::set(1.90821492927058770002e-10)));
+            return V::sub(V::mul(e, V::set(6.93147180369123816490e-01)), V::sub(V::sub(hfsq, lo), f));
+        }
+
+        //! @brief Exponential of reals (clamped to the range of normal results, within a few ulps).
+        template <typename V>
+        typename V::real exp(typename V::real x) {
+            using R = typename V::real;
+            x = V::min(V::max(x, V::set(-708)), V::set(709));
+            // x = n * ln(2) + r with |r| <= ln(2)/2, rounding through the mantissa of 1.5 * 2^52
+            R k = V::add(V::mul(x, V::set(1.44269504088896338700)), V::set(0x1.8p52));
+            R n = V::sub(k, V::set(0x1.8p52));
+            R r = V::sub(V::sub(x, V::mul(n, V::set(6.93147180369123816490e-01))), V::mul(n, V::set(1.90821492927058770002e-10)));
+            // Taylor polynomial of degree 12 (truncation error below 2^-52)
+            R p = V::set(1.0 / 479001600);
+            for (double c : {1.0 / 39916800, 1.0 / 3628800, 1.0 / 362880, 1.0 / 40320, 1.0 / 5040, 1.0 / 720, 1.0 / 120, 1.0 / 24, 1.0 / 6, 0.5, 1.0, 1.0})
+                p = V::add(V::mul(p, r), V::set(c));
+            // 2^n, with n read from the mantissa of k
+            typename V::word i = V::sub(V::as_word(k), V::as_word(V::set(0x1.8p52)));
+            return V::mul(p, V::as_real(V::shift_left(V::add(i, V::set_word(1023)), 52)));
+        }
+
+        //! @brief Applies a function to the lanes of `x` from position `i`, for as long as lanes are full.
+        template <typename V, typename F>
+        void transform(double* x, size_t& i, size_t n, F&& f) {
+            // two independent polynomial chains per step hide the latency of the multiply-add sequences
+            for (; i + 2 * V::width <= n; i += 2 * V::width) {
+                typename V::real a = f(V::load(x + i));
+                typename V::real b = f(V::load(x + i + V::width));
+                V::store(x + i, a);
+                V::store(x + i + V::width, b);
+            }
+            for (; i + V::width <= n; i += V::width) V::store(x + i, f(V::load(x + i)));
+        }
+
+        //! @brief Sets `x[i] = -log(x[i])` for `n` reals in (0,1].
+        template <typename V>
+        void neg_log(double* x, size_t& i, size_t n) {
+            transform<V>(x, i, n, [](typename V::real y){
+                return V::sub(V::set(0), log<V>(y));
+            });
+        }
+
+        //! @brief Sets `x[i] = pow(x[i], p)` for `n` non-negative reals (with zero mapped to zero).
+        template <typename V>
+        void power(double* x, size_t& i, size_t n, double p) {
+            transform<V>(x, i, n, [p](typename V::real y){
+                return V::bit_and(V::greater(y, V::set(0)), exp<V>(V::mul(V::set(p), log<V>(y))));
+            });
+        }
+
+        //! @brief Fills `n` uniform reals in (0,1] from the counters of a given key.
+        template <typename V>
+        void uniform(double* x, size_t& i, size_t n, uint64_t key) {
+            typename V::word c = V::counters(key + i * step);
+            typename V::word d = V::set_word(V::width * step);
+            for (; i + V::width <= n; i += V::width) {
+                V::store(x + i, unit<V>(c));
+                c = V::add(c, d);
+            }
+        }
+
+        //! @brief Calls a generic function on the vector lanes first (if available), and on single lanes then.
+        template <typename F>
+        void for_lanes(F&& f) {
+#if defined(__AVX2__) || defined(__SSE2__)
+            f(vector_lanes{});
+#endif
+            f(scalar_lanes{});
+        }
+    }
+    //! @endcond
+
+    /**
+     * @brief Fills `n` uniform reals in (0,1] from the counters of a given key.
+     *
+     * For doubles, counters are hashed on vector lanes, with the same results as the scalar loop.
+     */
+    template <typename R>
+    void uniform(R* x, size_t n, uint64_t key) {
+        if constexpr (std::is_same<R, double>::value) {
+            size_t i = 0;
+            details::for_lanes([&](auto v){
+                details::uniform<decltype(v)>(x, i, n, key);
+            });
+        } else for (size_t i = 0; i < n; ++i)
+            x[i] = R((hash_mix(key + i * step) >> 11) + 1) * R(0x1.0p-53);
+    }
+
+    //! @brief Maps `n` uniform reals in (0,1] to a uniform real distribution.
+    template <typename R>
+    void inverse_cdf(R* x, size_t n, std::uniform_real_distribution<R> const& d) {
+        R a = d.a(), w = d.b() - d.a();
+        for (size_t i = 0; i < n; ++i) x[i] = a + w * (1 - x[i]);
+    }
+
+    /**
+     * @brief Maps `n` uniform reals in (0,1] to a Weibull distribution.
+     *
+     * For doubles, logarithms and powers are computed by polynomial kernels on vector lanes (and
+     * on single lanes for the rest), so that results do not depend on the position in the array.
+     */
+    template <typename R>
+    void inverse_cdf(R* x, size_t n, std::weibull_distribution<R> const& d) {
+        R ia = 1 / d.a(), b = d.b();
+        if constexpr (std::is_same<R, double>::value) {
+            size_t i = 0;
+            details::for_lanes([&](auto v){
+                details::neg_log<decltype(v)>(x, i, n);
+            });
+            if (ia != 1) {
+                i = 0;
+                details::for_lanes([&](auto v){
+                    details::power<decltype(v)>(x, i, n, ia);
+                });
+            }
+            for (i = 0; i < n; ++i) x[i] *= b;
+        } else for (size_t i = 0; i < n; ++i) x[i] = b * std::pow(-std::log(x[i]), ia);
+    }
+
+    /**
+     * @brief Maps `n` uniform reals in (0,1] to an exponential distribution.
+     *
+     * For doubles, logarithms are computed as for Weibull distributions.
+     */
+    template <typename R>
+    void inverse_cdf(R* x, size_t n, std::exponential_distribution<R> const& d) {
+        R il = 1 / d.lambda();
+        if constexpr (std::is_same<R, double>::value) {
+            size_t i = 0;
+            details::for_lanes([&](auto v){
+                details::neg_log<decltype(v)>(x, i, n);
+            });
+            for (i = 0; i < n; ++i) x[i] *= il;
+        } else for (size_t i = 0; i < n; ++i) x[i] = -std::log(x[i]) * il;
+    }
+
+    //! @brief Fills `n` reals following a given distribution from the counters of a given key.
+    template <typename R, typename D>
+    void fill(R* x, size_t n, uint64_t key, D const& d) {
+        uniform(x, n, key);
+        inverse_cdf(x, n, d);
+    }
+}
+
+
+}
+
+#endif // FCPP_FIELD_RANDOM_H_
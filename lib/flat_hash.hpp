@@ -0,0 +1,584 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file flat_hash.hpp
+ * @brief Flat open-addressing hash sets and maps, probing groups of slots with SIMD instructions.
+ */
+
+#ifndef FCPP_FLAT_HASH_H_
+#define FCPP_FLAT_HASH_H_
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Mixes the bits of a 64-bit integer (MurmurHash3 finaliser).
+inline uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+//! @brief Hasher mixing the bits of the standard hash of a type, so that all bits of the result are significant.
+template <typename T>
+struct mixing_hash {
+    //! @brief Computes the hash of a value.
+    size_t operator()(T const& x) const {
+        return hash_mix(std::hash<T>{}(x));
+    }
+};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Control byte of an empty slot.
+    constexpr int8_t ctrl_empty = -128;
+
+    //! @brief Control byte of a slot whose element has been erased.
+    constexpr int8_t ctrl_deleted = -2;
+
+    //! @brief Number of slots in a probing group.
+    constexpr size_t group_width = 16;
+
+    //! @brief A group of control bytes, matched all at once.
+    class ctrl_group {
+      public:
+        //! @brief Loads the group starting at a given control byte.
+        explicit ctrl_group(int8_t const* p) {
+#ifdef __SSE2__
+            m_ctrl = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+#else
+            std::memcpy(m_ctrl, p, group_width);
+#endif
+        }
+
+        //! @brief Bitmask of the slots with a given control byte.
+        uint32_t match(int8_t h) const {
+#ifdef __SSE2__
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), m_ctrl));
+#else
+            uint32_t r = 0;
+            for (size_t i = 0; i < group_width; ++i) r |= uint32_t(m_ctrl[i] == h) << i;
+            return r;
+#endif
+        }
+
+        //! @brief Bitmask of the empty slots.
+        uint32_t match_empty() const {
+            return match(ctrl_empty);
+        }
+
+        //! @brief Bitmask of the empty or erased slots.
+        uint32_t match_free() const {
+#ifdef __SSE2__
+            return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), m_ctrl));
+#else
+            uint32_t r = 0;
+            for (size_t i = 0; i < group_width; ++i) r |= uint32_t(m_ctrl[i] < -1) << i;
+            return r;
+#endif
+        }
+
+      private:
+        //! @brief The control bytes.
+#ifdef __SSE2__
+        __m128i m_ctrl;
+#else
+        int8_t m_ctrl[group_width];
+#endif
+    };
+
+    //! @brief Index of the lowest set bit of a non-null mask.
+    inline size_t lowest_bit(uint32_t m) {
+        return __builtin_ctz(m);
+    }
+
+    //! @brief Extracts the key of a set element.
+    struct set_key {
+        template <typename T>
+        T const& operator()(T const& x) const {
+            return x;
+        }
+    };
+
+    //! @brief Extracts the key of a map element.
+    struct map_key {
+        template <typename T>
+        typename T::first_type const& operator()(T const& x) const {
+            return x.first;
+        }
+    };
+
+    /**
+     * @brief Open-addressing hash table with control bytes probed in groups.
+     *
+     * Every slot has a control byte, which is either empty, erased, or holds 7 bits of the hash
+     * of the element in the slot. Lookups compare a whole group of control bytes at once, and
+     * only access the slots with matching bits. The first control bytes are mirrored past the
+     * end of the table, so that groups can be loaded at any position.
+     *
+     * @param T The type of elements.
+     * @param K The type of keys.
+     * @param X Extractor of keys from elements.
+     * @param H Hasher of keys.
+     * @param E Equality predicate of keys.
+     */
+    template <typename T, typename K, typename X, typename H, typename E>
+    class flat_table {
+      public:
+        //! @brief The type of keys.
+        using key_type = K;
+
+        //! @brief The type of elements.
+        using value_type = T;
+
+        //! @brief Iterator through the elements.
+        template <bool is_const>
+        class basic_iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = std::conditional_t<is_const, T const&, T&>;
+            using pointer = std::conditional_t<is_const, T const*, T*>;
+
+            basic_iterator() = default;
+
+            basic_iterator(int8_t const* ctrl, pointer slot, pointer end) : m_ctrl(ctrl), m_slot(slot), m_end(end) {
+                skip();
+            }
+
+            //! @brief Conversion to const iterator.
+            operator basic_iterator<true>() const {
+                return {m_ctrl, m_slot, m_end};
+            }
+
+            reference operator*() const {
+                return *m_slot;
+            }
+
+            pointer operator->() const {
+                return m_slot;
+            }
+
+            basic_iterator& operator++() {
+                ++m_ctrl;
+                ++m_slot;
+                skip();
+                return *this;
+            }
+
+            basic_iterator operator++(int) {
+                basic_iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            bool operator==(basic_iterator const& o) const {
+                return m_slot == o.m_slot;
+            }
+
+            bool operator!=(basic_iterator const& o) const {
+                return m_slot != o.m_slot;
+            }
+
+          private:
+            //! @brief Advances to the next full slot.
+            void skip() {
+                while (m_slot != m_end and *m_ctrl < 0) {
+                    ++m_ctrl;
+                    ++m_slot;
+                }
+            }
+
+            int8_t const* m_ctrl = nullptr;
+            pointer m_slot = nullptr;
+            pointer m_end = nullptr;
+        };
+
+        //! @brief Iterator type.
+        using iterator = basic_iterator<false>;
+
+        //! @brief Const iterator type.
+        using const_iterator = basic_iterator<true>;
+
+        //! @name constructors
+        //! @{
+        flat_table() = default;
+
+        flat_table(flat_table const& o) {
+            reserve(o.m_size);
+            for (T const& x : o) emplace_new(x);
+        }
+
+        flat_table(flat_table&& o) noexcept {
+            swap(o);
+        }
+
+        flat_table(std::initializer_list<T> l) {
+            insert(l.begin(), l.end());
+        }
+
+        template <typename I>
+        flat_table(I first, I last) {
+            insert(first, last);
+        }
+        //! @}
+
+        ~flat_table() {
+            destroy();
+        }
+
+        //! @name assignment operators
+        //! @{
+        flat_table& operator=(flat_table const& o) {
+            if (this != &o) {
+                flat_table t(o);
+                swap(t);
+            }
+            return *this;
+        }
+
+        flat_table& operator=(flat_table&& o) noexcept {
+            swap(o);
+            return *this;
+        }
+        //! @}
+
+        //! @brief Exchanges content with another table.
+        void swap(flat_table& o) noexcept {
+            std::swap(m_ctrl, o.m_ctrl);
+            std::swap(m_slots, o.m_slots);
+            std::swap(m_capacity, o.m_capacity);
+            std::swap(m_size, o.m_size);
+            std::swap(m_growth, o.m_growth);
+        }
+
+        //! @name iterators
+        //! @{
+        iterator begin() {
+            return {m_ctrl, m_slots, m_slots + m_capacity};
+        }
+
+        const_iterator begin() const {
+            return {m_ctrl, m_slots, m_slots + m_capacity};
+        }
+
+        iterator end() {
+            return {m_ctrl, m_slots + m_capacity, m_slots + m_capacity};
+        }
+
+        const_iterator end() const {
+            return {m_ctrl, m_slots + m_capacity, m_slots + m_capacity};
+        }
+        //! @}
+
+        //! @brief Number of elements.
+        size_t size() const {
+            return m_size;
+        }
+
+        //! @brief Whether the table has no elements.
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        //! @brief Removes all elements (keeping capacity).
+        void clear() {
+            if (m_size > 0) for (size_t i = 0; i < m_capacity; ++i) if (m_ctrl[i] >= 0) m_slots[i].~T();
+            if (m_capacity > 0) std::memset(m_ctrl, ctrl_empty, m_capacity + group_width);
+            m_size = 0;
+            m_growth = max_load(m_capacity);
+        }
+
+        //! @brief Ensures room for a given number of elements without rehashing.
+        void reserve(size_t n) {
+            if (n > max_load(m_capacity)) rehash(n);
+        }
+
+        //! @brief Finds the element with a given key.
+        iterator find(K const& k) {
+            return iterator_at(locate(k));
+        }
+
+        //! @brief Finds the element with a given key (const overload).
+        const_iterator find(K const& k) const {
+            return iterator_at(locate(k));
+        }
+
+        //! @brief Number of elements with a given key (either 0 or 1).
+        size_t count(K const& k) const {
+            return locate(k) < m_capacity;
+        }
+
+        //! @brief Inserts an element if its key is not present.
+        std::pair<iterator, bool> insert(T const& x) {
+            return emplace(x);
+        }
+
+        //! @brief Inserts an element if its key is not present (move overload).
+        std::pair<iterator, bool> insert(T&& x) {
+            return emplace(std::move(x));
+        }
+
+        //! @brief Inserts a range of elements.
+        template <typename I>
+        void insert(I first, I last) {
+            for (; first != last; ++first) emplace(*first);
+        }
+
+        //! @brief Constructs an element if its key is not present.
+        template <typename... Ts>
+        std::pair<iterator, bool> emplace(Ts&&... xs) {
+            T x(std::forward<Ts>(xs)...);
+            K const& k = X{}(x);
+            size_t h = H{}(k);
+            size_t i = locate(k, h);
+            if (i < m_capacity) return {iterator_at(i), false};
+            return {iterator_at(place(std::move(x), h)), true};
+        }
+
+        //! @brief Erases the element with a given key, returning the number of elements erased.
+        size_t erase(K const& k) {
+            size_t i = locate(k);
+            if (i == m_capacity) return 0;
+            erase_at(i);
+            return 1;
+        }
+
+        //! @brief Erases the element pointed by an iterator.
+        void erase(const_iterator it) {
+            erase_at(&*it - m_slots);
+        }
+
+        //! @brief Equality operator.
+        bool operator==(flat_table const& o) const {
+            if (m_size != o.m_size) return false;
+            for (T const& x : *this) {
+                auto it = o.find(X{}(x));
+                if (it == o.end() or not (*it == x)) return false;
+            }
+            return true;
+        }
+
+        //! @brief Inequality operator.
+        bool operator!=(flat_table const& o) const {
+            return not (*this == o);
+        }
+
+      protected:
+        //! @brief Slot index of the element with a given key (capacity if absent).
+        size_t locate(K const& k) const {
+            return locate(k, H{}(k));
+        }
+
+        //! @brief Slot index of the element with a given key and hash (capacity if absent).
+        size_t locate(K const& k, size_t h) const {
+            if (m_capacity == 0) return 0;
+            size_t mask = m_capacity - 1;
+            int8_t h2 = h & 0x7F;
+            for (size_t pos = (h >> 7) & mask, step = group_width; ; pos = (pos + step) & mask, step += group_width) {
+                ctrl_group g(m_ctrl + pos);
+                for (uint32_t m = g.match(h2); m; m &= m - 1) {
+                    size_t i = (pos + lowest_bit(m)) & mask;
+                    if (E{}(X{}(m_slots[i]), k)) return i;
+                }
+                if (g.match_empty()) return m_capacity;
+            }
+        }
+
+        //! @brief Places an element whose key is known to be absent, returning its slot.
+        size_t place(T&& x, size_t h) {
+            if (m_growth == 0) rehash(m_size + 1);
+            size_t i = free_slot(h);
+            m_growth -= m_ctrl[i] == ctrl_empty;
+            set_ctrl(i, h & 0x7F);
+            new (m_slots + i) T(std::move(x));
+            ++m_size;
+            return i;
+        }
+
+        //! @brief Inserts a copy of an element whose key is known to be absent.
+        void emplace_new(T const& x) {
+            place(T(x), H{}(X{}(x)));
+        }
+
+        //! @brief Erases the element in a given slot.
+        void erase_at(size_t i) {
+            m_slots[i].~T();
+            --m_size;
+            // the slot can be emptied if every group containing it has an empty slot (no probe passed beyond it)
+            size_t mask = m_capacity - 1;
+            uint32_t after = ctrl_group(m_ctrl + i).match_empty();
+            uint32_t before = ctrl_group(m_ctrl + ((i - group_width) & mask)).match_empty();
+            bool isolated = after and before and lowest_bit(after) + __builtin_clz(before) - (32 - group_width) < group_width;
+            set_ctrl(i, isolated ? ctrl_empty : ctrl_deleted);
+            m_growth += isolated;
+        }
+
+        //! @brief Number of slots (also returned by `locate` for missing keys).
+        size_t capacity() const {
+            return m_capacity;
+        }
+
+        //! @brief Iterator to the element in a given slot.
+        iterator iterator_at(size_t i) {
+            return {m_ctrl + i, m_slots + i, m_slots + m_capacity};
+        }
+
+        //! @brief Iterator to the element in a given slot (const overload).
+        const_iterator iterator_at(size_t i) const {
+            return {m_ctrl + i, m_slots + i, m_slots + m_capacity};
+        }
+
+      private:
+        //! @brief Maximum number of elements for a given capacity (7/8 load factor).
+        static size_t max_load(size_t capacity) {
+            return capacity - capacity / 8;
+        }
+
+        //! @brief First empty or erased slot in the probe sequence of a hash.
+        size_t free_slot(size_t h) const {
+            size_t mask = m_capacity - 1;
+            for (size_t pos = (h >> 7) & mask, step = group_width; ; pos = (pos + step) & mask, step += group_width) {
+                uint32_t m = ctrl_group(m_ctrl + pos).match_free();
+                if (m) return (pos + lowest_bit(m)) & mask;
+            }
+        }
+
+        //! @brief Sets the control byte of a slot (and its mirror).
+        void set_ctrl(size_t i, int8_t c) {
+            m_ctrl[i] = c;
+            if (i < group_width) m_ctrl[i + m_capacity] = c;
+        }
+
+        //! @brief Rebuilds the table with room for at least a given number of elements.
+        void rehash(size_t n) {
+            size_t capacity = group_width;
+            while (max_load(capacity) < n) capacity *= 2;
+            flat_table t;
+            t.m_capacity = capacity;
+            t.m_ctrl = std::allocator<int8_t>{}.allocate(capacity + group_width);
+            t.m_slots = std::allocator<T>{}.allocate(capacity);
+            t.clear();
+            for (size_t i = 0; i < m_capacity; ++i) if (m_ctrl[i] >= 0) {
+                t.place(std::move(m_slots[i]), H{}(X{}(m_slots[i])));
+            }
+            swap(t);
+        }
+
+        //! @brief Destroys elements and releases memory.
+        void destroy() {
+            if (m_capacity == 0) return;
+            for (size_t i = 0; i < m_capacity; ++i) if (m_ctrl[i] >= 0) m_slots[i].~T();
+            std::allocator<int8_t>{}.deallocate(m_ctrl, m_capacity + group_width);
+            std::allocator<T>{}.deallocate(m_slots, m_capacity);
+        }
+
+        //! @brief The control bytes (with the first group mirrored at the end).
+        int8_t* m_ctrl = nullptr;
+        //! @brief The slots for elements.
+        T* m_slots = nullptr;
+        //! @brief The number of slots (zero or a power of two).
+        size_t m_capacity = 0;
+        //! @brief The number of elements.
+        size_t m_size = 0;
+        //! @brief The number of empty slots that can still be filled before rehashing.
+        size_t m_growth = 0;
+    };
+}
+//! @endcond
+
+
+//! @brief Flat hash set with open addressing.
+template <typename K, typename H = mixing_hash<K>, typename E = std::equal_to<K>>
+class flat_hash_set : public details::flat_table<K, K, details::set_key, H, E> {
+    using base = details::flat_table<K, K, details::set_key, H, E>;
+
+  public:
+    using base::base;
+
+    //! @brief Serialisation is that of the sequence of elements.
+    using sequence_serialization = void;
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        std::vector<K> v(this->begin(), this->end());
+        s & v;
+        this->clear();
+        this->insert(v.begin(), v.end());
+        return s;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << std::vector<K>(this->begin(), this->end());
+    }
+};
+
+
+//! @brief Flat hash map with open addressing.
+template <typename K, typename V, typename H = mixing_hash<K>, typename E = std::equal_to<K>>
+class flat_hash_map : public details::flat_table<std::pair<K, V>, K, details::map_key, H, E> {
+    using base = details::flat_table<std::pair<K, V>, K, details::map_key, H, E>;
+
+  public:
+    using base::base;
+
+    //! @brief Serialisation is that of the sequence of elements.
+    using sequence_serialization = void;
+
+    //! @brief The type of mapped values.
+    using mapped_type = V;
+
+    //! @brief Access to the value with a given key, inserting a default one if absent.
+    V& operator[](K const& k) {
+        size_t h = H{}(k);
+        size_t i = this->locate(k, h);
+        if (i == this->capacity()) i = this->place(std::pair<K, V>(k, V{}), h);
+        return this->iterator_at(i)->second;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        std::vector<std::pair<K, V>> v(this->begin(), this->end());
+        s & v;
+        this->clear();
+        this->insert(v.begin(), v.end());
+        return s;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << std::vector<std::pair<K, V>>(this->begin(), this->end());
+    }
+};
+
+
+} // fcpp
+
+#endif // FCPP_FLAT_HASH_H_
@@ -8,10 +8,27 @@
 #ifndef FCPP_GENERALS_H_
 #define FCPP_GENERALS_H_
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <tuple>
+#include <vector>
+
 #include "lib/beautify.hpp"
 #include "lib/coordination.hpp"
 #include "lib/data.hpp"
 
+#include "lib/export_codec.hpp"
+#include "lib/field_random.hpp"
+#include "lib/flat_hash.hpp"
+#include "lib/profiler.hpp"
+#include "lib/simd_bloom.hpp"
+#include "lib/simd_field.hpp"
+#include "lib/size_stream.hpp"
+
 //! @brief Types of messages
 enum class msgtype {
     NONE,    // irrelevant
@@ -53,10 +70,12 @@ struct message {
         return from == m.from and to == m.to and time == m.time and data == m.data;
     }
 
-    //! @brief Hash computation.
+    //! @brief Hash computation, mixing all the bits of time, from and to.
     size_t hash() const {
-        constexpr size_t offs = sizeof(size_t)*CHAR_BIT/3;
-        return (size_t(time) << (2*offs)) | (size_t(from) << (offs)) | size_t(to);
+        uint64_t t = 0;
+        fcpp::times_t tn = time == 0 ? 0 : time; // positive and negative zeros compare equal
+        std::memcpy(&t, &tn, sizeof(fcpp::times_t));
+        return fcpp::hash_mix(fcpp::hash_mix(fcpp::hash_mix(t) ^ uint64_t(from)) ^ uint64_t(to));
     }
 
     //! @brief Serialises the content from/to a given input/output stream.
@@ -77,7 +96,7 @@ namespace std {
     //! @brief Hasher object for the message struct.
     template <>
     struct hash<message> {
-        //! @brief Produces an hash for a message, combining to and from into a size_t.
+        //! @brief Produces an hash for a message, mixing time, from and to into a size_t.
         size_t operator()(message const& m) const {
             return m.hash();
         }
@@ -85,6 +104,357 @@ namespace std {
 }
 
 
+//! @brief Log of the messages delivered to a node, updated in place and forgetting entries older than a given time.
+class delivery_ledger {
+  public:
+    //! @brief Registers the delivery of a message at a given time, returning whether it is its first delivery.
+    bool insert(message const& m, fcpp::times_t t) {
+        if (not m_delivered.insert(m).second) return false;
+        m_queue.emplace_back(t, m);
+        return true;
+    }
+
+    //! @brief Forgets messages delivered before a given time.
+    void expire(fcpp::times_t t) {
+        while (not m_queue.empty() and m_queue.front().first < t) {
+            m_delivered.erase(m_queue.front().second);
+            m_queue.pop_front();
+        }
+    }
+
+    //! @brief The number of messages remembered.
+    size_t size() const {
+        return m_delivered.size();
+    }
+
+  private:
+    //! @brief The messages remembered.
+    fcpp::flat_hash_set<message> m_delivered;
+    //! @brief The messages remembered with their delivery time, in order of delivery.
+    std::deque<std::pair<fcpp::times_t, message>> m_queue;
+};
+
+//! @brief Printing a delivery ledger.
+inline std::ostream& operator<<(std::ostream& o, delivery_ledger const& l) {
+    return o << l.size() << " delivered";
+}
+
+
+/**
+ * @brief Bytes exported by a node in a round, broken down per call point and per process.
+ *
+ * Bytes are recorded on behalf of a process while it runs, and attributed to a call point
+ * (e.g. of a spawn) when it is closed. Records are kept until the meter is cleared. The full
+ * size of every value metered (by processes or not) is also summed, to be checked against the
+ * size of the message actually sent.
+ */
+class export_meter {
+  public:
+    //! @brief Bytes exported through a call point.
+    struct call_point_data {
+        //! @brief Total bytes.
+        size_t bytes = 0;
+        //! @brief Number of processes.
+        size_t processes = 0;
+        //! @brief Bytes of the largest process.
+        size_t max_process = 0;
+    };
+
+    //! @brief Forgets all records (to be called at the start of every round).
+    void clear() {
+        m_open.clear();
+        m_call_points.clear();
+        m_total = 0;
+        m_wire = 0;
+    }
+
+    //! @brief Records bytes exported on behalf of a process (given their full size, if not all sent).
+    void record(message const& m, size_t bytes, size_t full) {
+        m_open[m] += bytes;
+        m_wire += full;
+    }
+
+    //! @brief Records bytes exported on behalf of a process.
+    void record(message const& m, size_t bytes) {
+        record(m, bytes, bytes);
+    }
+
+    //! @brief Records the full size of a value exported outside of processes.
+    void wire(size_t full) {
+        m_wire += full;
+    }
+
+    //! @brief Attributes the bytes recorded since the last closure to a call point, returning them.
+    call_point_data close(fcpp::trace_t cp) {
+        call_point_data r;
+        for (auto const& p : m_open) {
+            r.bytes += p.second;
+            r.max_process = std::max(r.max_process, p.second);
+        }
+        r.processes = m_open.size();
+        call_point_data& d = m_call_points[cp];
+        d.bytes += r.bytes;
+        d.processes += r.processes;
+        d.max_process = std::max(d.max_process, r.max_process);
+        m_total += r.bytes;
+        m_open.clear();
+        return r;
+    }
+
+    //! @brief Bytes attributed to a call point.
+    call_point_data call_point(fcpp::trace_t cp) const {
+        auto it = m_call_points.find(cp);
+        return it == m_call_points.end() ? call_point_data{} : it->second;
+    }
+
+    //! @brief Bytes attributed to every call point.
+    fcpp::flat_hash_map<fcpp::trace_t, call_point_data> const& call_points() const {
+        return m_call_points;
+    }
+
+    //! @brief Bytes recorded for every process since the last closure.
+    fcpp::flat_hash_map<message, size_t> const& processes() const {
+        return m_open;
+    }
+
+    //! @brief Total bytes attributed to call points.
+    size_t total() const {
+        return m_total;
+    }
+
+    //! @brief Total full size of the values metered.
+    size_t wire_bytes() const {
+        return m_wire;
+    }
+
+  private:
+    //! @brief Bytes recorded for every process since the last closure.
+    fcpp::flat_hash_map<message, size_t> m_open;
+    //! @brief Bytes attributed to every call point.
+    fcpp::flat_hash_map<fcpp::trace_t, call_point_data> m_call_points;
+    //! @brief Total bytes attributed to call points.
+    size_t m_total = 0;
+    //! @brief Total full size of the values metered.
+    size_t m_wire = 0;
+};
+
+
+//! @brief Policies ranking the processes of a node, those ranked lowest being evicted first.
+enum class eviction {
+    oldest,         //!< Evicts the processes created earliest.
+    farthest,       //!< Evicts the processes which reached the node latest after their creation.
+    lowest_priority //!< Evicts the processes with the lowest message data.
+};
+
+//! @brief Policies for the admission of processes new to a node.
+enum class admission {
+    ranked,   //!< New processes compete with running ones by rank.
+    incumbent //!< Running processes are kept before new ones.
+};
+
+//! @brief Budget of processes run by a node (unbounded by default).
+struct process_budget {
+    //! @brief Maximum number of processes.
+    size_t count = std::numeric_limits<size_t>::max();
+    //! @brief Maximum bytes exported on behalf of processes.
+    size_t bytes = std::numeric_limits<size_t>::max();
+    //! @brief Eviction policy.
+    eviction evict = eviction::oldest;
+    //! @brief Admission policy.
+    admission admit = admission::ranked;
+
+    //! @brief Whether the budget is bounded.
+    bool bounded() const {
+        return count < std::numeric_limits<size_t>::max() or bytes < std::numeric_limits<size_t>::max();
+    }
+};
+
+/**
+ * @brief Admission plan of the processes of a node under a budget, updated in place.
+ *
+ * In every round, processes planned in the previous round run, and new ones run while the budget
+ * has room. At the end of the round, the processes met are ranked by policy and planned in order
+ * while they fit the budget (by count and by the bytes they last exported): running processes
+ * left out of the plan are evicted.
+ */
+class budget_ledger {
+  public:
+    //! @brief Whether a process can run in the current round, at a given time.
+    bool admit(message const& m, fcpp::times_t t, process_budget const& b) {
+        auto it = m_entries.find(m);
+        if (it == m_entries.end()) it = m_entries.emplace(m, entry{t, m_max_bytes}).first;
+        entry& e = it->second;
+        if (e.round != m_round) {
+            e.round = m_round;
+            m_met.push_back(m);
+        }
+        if (e.running) return true;
+        if (not e.planned) {
+            if (m_count + m_extra_count >= b.count or m_bytes + m_extra_bytes + e.bytes > b.bytes) return false;
+            m_extra_count += 1;
+            m_extra_bytes += e.bytes;
+        }
+        e.running = true;
+        return true;
+    }
+
+    //! @brief Plans the next round given the bytes exported by processes, returning the number of evictions.
+    size_t plan(fcpp::flat_hash_map<message, size_t> const& bytes, process_budget const& b) {
+        std::vector<std::tuple<bool, fcpp::real_t, entry*>> ranked;
+        for (message const& m : m_met) {
+            entry& e = m_entries.find(m)->second;
+            auto it = bytes.find(m);
+            if (it != bytes.end()) {
+                e.bytes = it->second;
+                m_max_bytes = std::max(m_max_bytes, e.bytes);
+            }
+            fcpp::real_t r = b.evict == eviction::oldest ? m.time : b.evict == eviction::farthest ? m.time - e.join : m.data;
+            ranked.emplace_back(b.admit == admission::incumbent and e.running, r, &e);
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [](auto const& x, auto const& y){
+            return std::make_pair(std::get<0>(x), std::get<1>(x)) > std::make_pair(std::get<0>(y), std::get<1>(y));
+        });
+        size_t evicted = 0;
+        m_count = m_bytes = 0;
+        for (auto const& x : ranked) {
+            entry& e = *std::get<2>(x);
+            e.planned = m_count < b.count and m_bytes + e.bytes <= b.bytes;
+            if (e.planned) {
+                m_count += 1;
+                m_bytes += e.bytes;
+            } else if (e.running) evicted += 1;
+            e.running = false;
+        }
+        // forgets the processes not met in this round
+        for (auto it = m_entries.begin(); it != m_entries.end(); ) {
+            auto x = it++;
+            if (x->second.round != m_round) m_entries.erase(x);
+        }
+        m_met.clear();
+        m_extra_count = m_extra_bytes = 0;
+        m_round += 1;
+        m_evicted += evicted;
+        return evicted;
+    }
+
+    //! @brief The number of processes planned.
+    size_t size() const {
+        return m_count;
+    }
+
+    //! @brief The total number of evictions.
+    size_t evicted() const {
+        return m_evicted;
+    }
+
+  private:
+    //! @brief Data about a process.
+    struct entry {
+        //! @brief Time at which the process was first met.
+        fcpp::times_t join;
+        //! @brief Bytes last exported on behalf of the process (or an estimate).
+        size_t bytes;
+        //! @brief Last round in which the process was met.
+        size_t round = size_t(-1);
+        //! @brief Whether the process is planned to run.
+        bool planned = false;
+        //! @brief Whether the process is running in the current round.
+        bool running = false;
+    };
+
+    //! @brief The processes met in the current and previous round.
+    fcpp::flat_hash_map<message, entry> m_entries;
+    //! @brief The processes met in the current round.
+    std::vector<message> m_met;
+    //! @brief The number of the current round.
+    size_t m_round = 0;
+    //! @brief The number and bytes of processes planned.
+    size_t m_count = 0, m_bytes = 0;
+    //! @brief The number and bytes of new processes admitted in the current round.
+    size_t m_extra_count = 0, m_extra_bytes = 0;
+    //! @brief The largest bytes exported on behalf of a process (estimate for new processes).
+    size_t m_max_bytes = 0;
+    //! @brief The total number of evictions.
+    size_t m_evicted = 0;
+};
+
+//! @brief Printing a budget ledger.
+inline std::ostream& operator<<(std::ostream& o, budget_ledger const& l) {
+    return o << l.size() << " planned, " << l.evicted() << " evicted";
+}
+
+/**
+ * @brief Backoff of the round rate of a node, updated in place.
+ *
+ * The backoff doubles in every round in which the node runs no process and has the same
+ * neighbours as in the previous round, up to a maximum, and is reset otherwise. Rounds follow
+ * the planned schedule delayed by a shift, which grows by the intervals skipped while backed off.
+ */
+class round_backoff {
+  public:
+    //! @brief Updates the backoff given the neighbours (sorted) and whether the node runs processes, returning it.
+    size_t update(std::vector<fcpp::device_t> const& nbrs, bool active, size_t max_backoff) {
+        if (active or nbrs != m_nbrs) m_backoff = 1;
+        else m_backoff = std::min(2 * m_backoff, max_backoff);
+        if (nbrs != m_nbrs) {
+            // neighbours in the last round which are now missing
+            std::vector<fcpp::device_t> lost;
+            std::set_difference(m_nbrs.begin(), m_nbrs.end(), nbrs.begin(), nbrs.end(), std::back_inserter(lost));
+            m_lost += lost.size();
+            m_nbrs = nbrs;
+        }
+        return m_backoff;
+    }
+
+    //! @brief The time of the next round, given the current time and the next time planned by the schedule (unaware of the shift).
+    fcpp::times_t next_time(fcpp::times_t t, fcpp::times_t planned) {
+        if (not (planned < std::numeric_limits<fcpp::times_t>::max())) return planned;
+        // the interval planned after the current round, counted from its planned time
+        fcpp::times_t interval = planned - (t - m_shift);
+        m_shift += (m_backoff - 1) * interval;
+        m_skipped += m_backoff - 1;
+        return planned + m_shift;
+    }
+
+    //! @brief The current backoff (multiplier of round intervals).
+    size_t backoff() const {
+        return m_backoff;
+    }
+
+    //! @brief The number of planned rounds skipped.
+    size_t skipped() const {
+        return m_skipped;
+    }
+
+    //! @brief The number of neighbours lost across rounds.
+    size_t lost() const {
+        return m_lost;
+    }
+
+  private:
+    //! @brief The neighbours in the last round.
+    std::vector<fcpp::device_t> m_nbrs;
+    //! @brief The current backoff.
+    size_t m_backoff = 1;
+    //! @brief The delay of rounds with respect to the planned schedule.
+    fcpp::times_t m_shift = 0;
+    //! @brief The number of planned rounds skipped.
+    size_t m_skipped = 0;
+    //! @brief The number of neighbours lost across rounds.
+    size_t m_lost = 0;
+};
+
+//! @brief Printing a round backoff.
+inline std::ostream& operator<<(std::ostream& o, round_backoff const& b) {
+    return o << "backoff " << b.backoff() << ", " << b.skipped() << " skipped";
+}
+
+//! @brief Printing an export meter.
+inline std::ostream& operator<<(std::ostream& o, export_meter const& e) {
+    return o << e.total() << " bytes in " << e.call_points().size() << " call points";
+}
+
+
 /**
  * @brief Namespace containing all the objects in the FCPP library.
  */
@@ -115,6 +485,10 @@ namespace tags {
     template <typename T>
     struct tree {};
 
+    //! @brief Tree process routed through Bloom filters (in co-simulations).
+    template <typename T>
+    struct bloom {};
+
 
     //! @brief The maximum number of processes ever run by the node.
     template <typename T>
@@ -136,6 +510,18 @@ namespace tags {
     template <typename T>
     struct repeat_count {};
 
+    //! @brief Log of delivered messages.
+    template <typename T>
+    struct delivery_log {};
+
+    //! @brief Admission plan of processes under a budget.
+    template <typename T>
+    struct budget_log {};
+
+    //! @brief Total number of processes evicted under a budget.
+    template <typename T>
+    struct evict_count {};
+
 
     //! @brief Average time of first delivery.
     template <typename T>
@@ -165,6 +551,34 @@ namespace tags {
     template <typename T>
     struct avgtot_size {};
 
+    //! @brief The maximum size of the export of a single process.
+    template <typename T>
+    struct max_proc_size {};
+
+    //! @brief Bytes exported in the current round, per call point and process.
+    struct export_log {};
+
+    //! @brief Delta encoder of the exports of the node.
+    struct export_codec_log {};
+
+    //! @brief The maximum size of messages actually sent by a device.
+    struct max_wire_size {};
+
+    //! @brief The total size of messages actually sent by a device.
+    struct tot_wire_size {};
+
+    //! @brief The maximum difference between the size of messages actually sent by a device and the size metered.
+    struct max_unmetered_size {};
+
+    //! @brief The total difference between the size of messages actually sent by a device and the size metered.
+    struct tot_unmetered_size {};
+
+    //! @brief Backoff of the round rate of the device.
+    struct backoff_log {};
+
+    //! @brief Total number of rounds executed by a device.
+    struct round_count {};
+
 
     //! @brief The variance of round timing in the network.
     struct tvar {};
@@ -196,6 +610,15 @@ namespace tags {
     //! @brief Total number of sent messages.
     struct sent_count {};
 
+    //! @brief State of the collection of routing sets.
+    struct below_state {};
+
+    //! @brief State of the collection of Bloom filters co-simulated with exact routing sets.
+    struct bloom_state {};
+
+    //! @brief Distances to neighbours, frozen under a static topology.
+    struct nbr_cache {};
+
     //! @brief Color of the current node.
     struct node_color {};
 
@@ -230,8 +653,15 @@ namespace tags {
 } // tags
 
 
+//! @brief Bytes taken by a value in an export (together with the trace identifying it).
+template <typename T>
+size_t export_bytes(T const& x) {
+    return sizeof(trace_t) + serialized_size(x);
+}
+
+
 //! @brief Distance estimation which can only decrease over time using given metric field of relative distances.
-GEN(T) real_t monotonic_distance(ARGS, bool source, field<T> const& rd) { CODE
+GEN(T) real_t monotonic_distance(ARGS, bool source, field<T> const& rd) { CODE PROFILE_CODE
     return nbr(CALL, INF, [&](field<real_t> nd){
         real_t mind = min_hood(CALL, nd + rd); // inclusive
         return source ? 0.0 : mind;
@@ -240,33 +670,161 @@ GEN(T) real_t monotonic_distance(ARGS, bool source, field<T> const& rd) { CODE
 //! @brief Export list for monotonic_distance.
 FUN_EXPORT monotonic_distance_t = export_list<real_t>;
 
+//! @brief Two distance estimations as in `monotonic_distance` from the same source, sharing a single `nbr` call.
+GEN(T,U) tuple<real_t, real_t> monotonic_distances(ARGS, bool source, field<T> const& rd1, field<U> const& rd2) { CODE PROFILE_CODE
+    return nbr(CALL, tuple<real_t, real_t>{INF, INF}, [&](field<tuple<real_t, real_t>> nd){
+        real_t mind1 = min_hood(CALL, get<0>(nd) + rd1); // inclusive
+        real_t mind2 = min_hood(CALL, get<1>(nd) + rd2); // inclusive
+        return source ? tuple<real_t, real_t>{0, 0} : tuple<real_t, real_t>{mind1, mind2};
+    });
+}
+//! @brief Export list for monotonic_distances.
+FUN_EXPORT monotonic_distances_t = export_list<tuple<real_t, real_t>>;
+
+
+/**
+ * @brief Distances to the neighbours of a device, computed once per round and frozen across rounds under a static topology.
+ *
+ * While devices do not move, distances are recomputed only when the neighbours change, and are
+ * also kept contiguously (excluding the device itself) for kernels on arrays.
+ */
+class frozen_neighbourhood {
+  public:
+    //! @brief The distances to neighbours in the current round, given whether the topology is static.
+    template <typename node_t>
+    field<real_t> const& dist(node_t& node, bool still) {
+        if (m_time == node.current_time() and m_valid) return m_dist;
+        m_time = node.current_time();
+        if (still and m_valid) {
+            std::vector<device_t> const& ids = fcpp::details::get_ids(node.nbr_uid());
+            if (ids == fcpp::details::get_ids(m_dist)) return m_dist;
+        }
+        m_dist = node.nbr_dist();
+        m_valid = true;
+        m_gather.domain(m_dist, node.uid);
+        m_gather.copy(m_dist, m_values, [](real_t d){ return d; });
+        ++m_rebuilds;
+        return m_dist;
+    }
+
+    //! @brief The neighbours (excluding the device itself).
+    std::vector<device_t> const& ids() const {
+        return m_gather.ids();
+    }
+
+    //! @brief The distances to neighbours, in the order of `ids`.
+    std::vector<real_t> const& values() const {
+        return m_values;
+    }
+
+    //! @brief The number of times distances were recomputed.
+    size_t rebuilds() const {
+        return m_rebuilds;
+    }
+
+  private:
+    //! @brief The distances to neighbours.
+    field<real_t> m_dist;
+    //! @brief The neighbours, excluding the device itself.
+    field_gather m_gather;
+    //! @brief The distances to neighbours, in the order of the gathered neighbours.
+    std::vector<real_t> m_values;
+    //! @brief The time of the round of the distances.
+    times_t m_time = 0;
+    //! @brief Whether distances were computed.
+    bool m_valid = false;
+    //! @brief The number of times distances were recomputed.
+    size_t m_rebuilds = 0;
+};
+
+//! @brief Printing a frozen neighbourhood.
+inline std::ostream& operator<<(std::ostream& o, frozen_neighbourhood const& n) {
+    return o << n.ids().size() << " neighbours, " << n.rebuilds() << " rebuilds";
+}
+
+//! @brief Distances to neighbours, frozen across rounds while devices do not move (speed zero).
+FUN field<real_t> const& cached_nbr_dist(ARGS) {
+    return node.storage(tags::nbr_cache{}).dist(node, node.storage(tags::speed{}) == 0);
+}
+
 
-//! @brief Computes stable parents through FLEX distance estimation.
-FUN device_t flex_parent(ARGS, bool source, real_t radius) { CODE
+//! @brief Contiguous buffers of neighbour values for flex_parent (reused across calls of a thread).
+struct flex_buffers {
+    //! @brief The neighbours.
+    field_gather gather;
+    //! @brief Distance estimates of neighbours.
+    std::vector<real_t> nd;
+    //! @brief Distances to neighbours.
+    std::vector<real_t> nbr;
+    //! @brief Distances to neighbours, bounded from below.
+    std::vector<real_t> dist;
+    //! @brief Distance estimates through neighbours.
+    std::vector<real_t> sum;
+    //! @brief Slopes of distance estimates.
+    std::vector<real_t> slope;
+};
+
+//! @brief Computes stable parents through FLEX distance estimation (on contiguous copies of neighbour values), setting the value exported.
+FUN device_t flex_parent(ARGS, bool source, real_t radius, tuple<real_t, device_t>& exported) { CODE PROFILE_CODE
     constexpr real_t epsilon = 0.5;
     constexpr real_t distortion = 0.1;
     tuple<real_t, device_t> loc{source ? 0 : INF, node.uid};
-    return get<1>(nbr(CALL, loc, [&] (field<tuple<real_t, device_t>> x) {
-        field<real_t> dist = max(node.nbr_dist(), distortion*radius);
+    exported = nbr(CALL, loc, [&] (field<tuple<real_t, device_t>> x) {
+        static thread_local flex_buffers b;
+        field<real_t> const& nbr_dist = cached_nbr_dist(CALL);
+        frozen_neighbourhood const& frozen = node.storage(tags::nbr_cache{});
+        b.gather.domain(node.nbr_uid(), node.uid);
+        b.gather.copy(x, b.nd, [](tuple<real_t, device_t> const& t){ return get<0>(t); });
+        if (b.gather.ids() == frozen.ids()) b.nbr = frozen.values();
+        else b.gather.copy(nbr_dist, b.nbr, [](real_t d){ return d; });
+        size_t n = b.gather.size();
+        b.dist.resize(n);
+        b.sum.resize(n);
+        simd::floor_add(b.nd.data(), b.nbr.data(), distortion*radius, b.dist.data(), b.sum.data(), n);
         tuple<real_t, device_t> const& old_di = self(CALL, x);
         real_t old_d = get<0>(old_di);
         device_t old_i = get<1>(old_di);
-        field<real_t> nd = get<0>(x);
-        tuple<real_t, device_t> new_di = min_hood(CALL, make_tuple(nd + dist, node.nbr_uid()), loc);
+        // lexicographic minimum of distance estimates through neighbours and their ids
+        tuple<real_t, device_t> new_di = loc;
+        real_t min_d = simd::min_value(b.sum.data(), n, get<0>(loc));
+        for (size_t i = 0; i < n; ++i) if (b.sum[i] == min_d) {
+            tuple<real_t, device_t> t{b.sum[i], b.gather.ids()[i]};
+            if (t < new_di) new_di = t;
+        }
         real_t new_d = get<0>(new_di);
         device_t new_i = get<1>(new_di);
-        tuple<real_t,real_t,real_t> slopeinfo = max_hood(CALL, make_tuple((old_d - nd)/dist, nd, dist), make_tuple(-INF, INF, 0));
         if (old_d == new_d or new_d == 0 or
             old_d > max(2*new_d, radius) or new_d > max(2*old_d, radius))
             return make_tuple(new_d, new_i);
-        if (fcpp::details::self(node.nbr_dist(), old_i) == INF or get<0>(fcpp::details::self(x, old_i)) > old_d)
+        if (fcpp::details::self(nbr_dist, old_i) == INF or get<0>(fcpp::details::self(x, old_i)) > old_d)
             old_i = new_i;
+        // lexicographic maximum of slopes, distance estimates and distances of neighbours
+        b.slope.resize(n);
+        simd::slope(old_d, b.nd.data(), b.dist.data(), b.slope.data(), n);
+        bool nan;
+        real_t max_s = simd::max_value(b.slope.data(), n, -INF, nan);
+        tuple<real_t,real_t,real_t> slopeinfo{-INF, INF, 0};
+        if (nan) {
+            // NaN slopes break the total order: falling back to the generic fold
+            field<real_t> dist = max(nbr_dist, distortion*radius);
+            field<real_t> nd = get<0>(x);
+            slopeinfo = max_hood(CALL, make_tuple((old_d - nd)/dist, nd, dist), slopeinfo);
+        } else for (size_t i = 0; i < n; ++i) if (b.slope[i] == max_s) {
+            tuple<real_t,real_t,real_t> t{b.slope[i], b.nd[i], b.dist[i]};
+            if (slopeinfo < t) slopeinfo = t;
+        }
         if (get<0>(slopeinfo) > 1 + epsilon)
             return make_tuple(get<1>(slopeinfo) + get<2>(slopeinfo) * (1 + epsilon), new_i);
         if (get<0>(slopeinfo) < 1 - epsilon)
             return make_tuple(get<1>(slopeinfo) + get<2>(slopeinfo) * (1 - epsilon), new_i);
         return make_tuple(old_d, new_i);
-    }));
+    });
+    return get<1>(exported);
+}
+//! @brief Computes stable parents through FLEX distance estimation (on contiguous copies of neighbour values).
+FUN device_t flex_parent(ARGS, bool source, real_t radius) {
+    tuple<real_t, device_t> exported;
+    return flex_parent(node, call_point, source, radius, exported);
 }
 //! @brief Export list for flex_parent.
 FUN_EXPORT flex_parent_t = export_list<tuple<real_t, device_t>>;
@@ -274,7 +832,7 @@ FUN_EXPORT flex_parent_t = export_list<tuple<real_t, device_t>>;
 
 //! @brief Collects distributed data with a single-path strategy according to given parents.
 GEN(T,G,BOUND(G, T(T,T)))
-T parent_collection(ARGS, device_t parent, T const& value, G&& accumulate) { CODE
+T parent_collection(ARGS, device_t parent, T const& value, G&& accumulate) { CODE PROFILE_CODE
     return nbr(CALL, T{}, [&](field<T> x){
         return fold_hood(CALL, accumulate, mux(nbr(CALL, parent) == node.uid, x, T{}), value);
     });
@@ -283,13 +841,316 @@ T parent_collection(ARGS, device_t parent, T const& value, G&& accumulate) { COD
 GEN_EXPORT(T) parent_collection_t = export_list<T, device_t>;
 
 
+/**
+ * @brief Node state of counting_collection: the counts of the filters of the node and of its children.
+ *
+ * The filter last received from every child is kept, so that when a child changes its filter or
+ * leaves, its contribution is removed from the counts instead of uniting all the children again.
+ */
+template <typename T>
+class counting_collection_state {
+  public:
+    //! @brief The type of elements.
+    using value_type = T;
+
+    //! @brief The collected filter.
+    dynamic_bloom_filter<T> const& set() const {
+        return m_counts.filter();
+    }
+
+    //! @brief Sets the filter of the node itself.
+    void self(dynamic_bloom_filter<T> const& f) {
+        if (f == m_self) return;
+        m_counts.erase(m_self);
+        m_counts.insert(f);
+        m_self = f;
+    }
+
+    //! @brief Sets the filter received from a child.
+    void child(device_t id, dynamic_bloom_filter<T> const& f) {
+        dynamic_bloom_filter<T>& c = m_children[id];
+        if (f == c) return;
+        m_counts.erase(c);
+        m_counts.insert(f);
+        c = f;
+    }
+
+    //! @brief Forgets the children not in a given list.
+    void retain(std::vector<device_t> const& children) {
+        std::vector<device_t> lost;
+        for (auto const& c : m_children)
+            if (std::find(children.begin(), children.end(), c.first) == children.end())
+                lost.push_back(c.first);
+        for (device_t c : lost) {
+            m_counts.erase(m_children.find(c)->second);
+            m_children.erase(c);
+        }
+    }
+
+  private:
+    //! @brief The counts of the filters of the node and of its children.
+    counting_bloom_filter<T> m_counts;
+    //! @brief The filter of the node itself.
+    dynamic_bloom_filter<T> m_self;
+    //! @brief The filters received from children.
+    flat_hash_map<device_t, dynamic_bloom_filter<T>> m_children;
+};
+
+/**
+ * @brief Collects Bloom filters with a single-path strategy according to given parents, as parent_collection.
+ *
+ * The filters of children are counted in a state updated in place, so that only the filters of
+ * children which changed, joined or left are processed in a round.
+ */
+GEN(T) dynamic_bloom_filter<T> const& counting_collection(ARGS, device_t parent, dynamic_bloom_filter<T> const& value, counting_collection_state<T>& state) { CODE PROFILE_CODE
+    field<device_t> parents = nbr(CALL, parent);
+    nbr(CALL, dynamic_bloom_filter<T>{}, [&](field<dynamic_bloom_filter<T>> x){
+        state.self(value);
+        std::vector<device_t> children;
+        for (device_t id : fcpp::details::get_ids(x)) if (id != node.uid and fcpp::details::self(parents, id) == node.uid) {
+            state.child(id, fcpp::details::self(x, id));
+            children.push_back(id);
+        }
+        state.retain(children);
+        return state.set();
+    });
+    return state.set();
+}
+//! @brief Export list for counting_collection.
+GEN_EXPORT(T) counting_collection_t = export_list<dynamic_bloom_filter<T>, device_t>;
+
+
+//! @brief Changes to a collected set, as exported by delta_collection.
+template <typename T>
+struct set_delta {
+    //! @brief The parent of the sender.
+    device_t parent = std::numeric_limits<device_t>::max();
+    //! @brief The version of the set after the changes.
+    size_t version = 0;
+    //! @brief The version the changes apply to (zero for a full snapshot).
+    size_t base = 0;
+    //! @brief Final presence of every element changed since the base version.
+    std::vector<std::pair<T, bool>> changes;
+    //! @brief Versions of the sets received from children.
+    std::vector<std::pair<device_t, size_t>> acks;
+
+    //! @brief The version of the set of a given child received by the sender (zero if none).
+    size_t ack(device_t child) const {
+        for (auto const& a : acks) if (a.first == child) return a.second;
+        return 0;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & parent & version & base & changes & acks;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << parent << version << base << changes << acks;
+    }
+};
+
+/**
+ * @brief Node state of delta_collection: the collected set, its change log and the sets of children.
+ *
+ * Every element is counted with its multiplicity among the node value and the children sets, so
+ * that changes of a child set are reflected on the collected set in time proportional to the changes.
+ */
+template <typename S>
+class delta_collection_state {
+  public:
+    //! @brief The type of elements.
+    using value_type = typename S::value_type;
+
+    //! @brief The collected set.
+    S const& set() const {
+        return m_set;
+    }
+
+    //! @brief Sets the value of the node itself.
+    void self(value_type const& x) {
+        if (m_has_self and m_self == x) return;
+        if (m_has_self) remove(m_self);
+        add(x);
+        m_self = x;
+        m_has_self = true;
+    }
+
+    //! @brief Applies changes received from a child (ignored if not applicable to the known version).
+    void apply(device_t child, set_delta<value_type> const& d) {
+        auto& c = m_children[child];
+        if (d.version == c.first) return;
+        if (d.base == 0) {
+            S snap;
+            for (auto const& x : d.changes) snap.insert(x.first);
+            for (value_type const& x : c.second) if (snap.count(x) == 0) remove(x);
+            for (value_type const& x : snap) if (c.second.count(x) == 0) add(x);
+            c.second = std::move(snap);
+        } else if (d.base <= c.first and c.first < d.version) {
+            for (auto const& x : d.changes) {
+                if (x.second and c.second.insert(x.first).second) add(x.first);
+                if (not x.second and c.second.erase(x.first)) remove(x.first);
+            }
+        } else return;
+        c.first = d.version;
+    }
+
+    //! @brief Forgets the children not in a given list.
+    void retain(std::vector<device_t> const& children) {
+        std::vector<device_t> lost;
+        for (auto const& c : m_children)
+            if (std::find(children.begin(), children.end(), c.first) == children.end())
+                lost.push_back(c.first);
+        for (device_t c : lost) {
+            for (value_type const& x : m_children.find(c)->second.second) remove(x);
+            m_children.erase(c);
+        }
+    }
+
+    //! @brief Closes the changes of the current round, producing the delta since a version acknowledged by the parent (if any).
+    set_delta<value_type> commit(device_t parent, size_t ack, bool has_parent = true) {
+        if (m_pending) ++m_version;
+        m_pending = false;
+        set_delta<value_type> d;
+        d.parent = parent;
+        d.version = m_version;
+        for (auto const& c : m_children) d.acks.emplace_back(c.first, c.second.first);
+        // entries already acknowledged are no longer needed
+        if (ack >= m_log_base and ack <= m_version) {
+            size_t i = 0;
+            while (i < m_log.size() and std::get<0>(m_log[i]) <= ack) ++i;
+            m_log.erase(m_log.begin(), m_log.begin() + i);
+            m_log_base = ack;
+        }
+        // compaction: a log longer than the set is dropped in favour of full snapshots
+        if (not has_parent or m_log.size() > m_set.size()) {
+            m_log.clear();
+            m_log_base = m_version;
+        }
+        if (not has_parent) {
+            d.base = m_version;
+        } else if (ack == 0 or ack < m_log_base or ack > m_version) {
+            for (value_type const& x : m_set) d.changes.emplace_back(x, true);
+        } else {
+            d.base = ack;
+            flat_hash_map<value_type, size_t> last;
+            for (auto const& e : m_log) {
+                auto it = last.find(std::get<1>(e));
+                if (it == last.end()) {
+                    last[std::get<1>(e)] = d.changes.size();
+                    d.changes.emplace_back(std::get<1>(e), std::get<2>(e));
+                } else d.changes[it->second].second = std::get<2>(e);
+            }
+        }
+        m_export_size = serialized_size(d);
+        return d;
+    }
+
+    //! @brief The serialised size of the last delta produced.
+    size_t export_size() const {
+        return m_export_size;
+    }
+
+  private:
+    //! @brief Counts an occurrence of an element.
+    void add(value_type const& x) {
+        if (m_count[x]++ > 0) return;
+        m_set.insert(x);
+        m_log.emplace_back(m_version + 1, x, true);
+        m_pending = true;
+    }
+
+    //! @brief Discounts an occurrence of an element.
+    void remove(value_type const& x) {
+        auto it = m_count.find(x);
+        if (--it->second > 0) return;
+        m_count.erase(x);
+        m_set.erase(x);
+        m_log.emplace_back(m_version + 1, x, false);
+        m_pending = true;
+    }
+
+    //! @brief The collected set.
+    S m_set;
+    //! @brief The multiplicity of the elements of the collected set.
+    flat_hash_map<value_type, size_t> m_count;
+    //! @brief The current version of the collected set.
+    size_t m_version = 0;
+    //! @brief Whether the set changed since the last version.
+    bool m_pending = false;
+    //! @brief The value of the node itself.
+    value_type m_self{};
+    //! @brief Whether the value of the node itself is set.
+    bool m_has_self = false;
+    //! @brief The changes after the base version, with the version they belong to.
+    std::vector<std::tuple<size_t, value_type, bool>> m_log;
+    //! @brief The version from which all changes are logged.
+    size_t m_log_base = 0;
+    //! @brief The sets received from children, with their version.
+    flat_hash_map<device_t, std::pair<size_t, S>> m_children;
+    //! @brief The serialised size of the last delta produced.
+    size_t m_export_size = 0;
+};
+
+//! @brief Printing a delta collection state.
+template <typename S>
+std::ostream& operator<<(std::ostream& o, delta_collection_state<S> const& s) {
+    return o << s.set().size() << " collected";
+}
+
+/**
+ * @brief Collects a set with a single-path strategy according to given parents, exchanging only changes.
+ *
+ * Every node exports the changes of its collected set since the version acknowledged by its parent,
+ * and the versions it has received from its children. In a stable tree, the cost of a round in time
+ * and message size is proportional to the changes, instead of the size of the collected set.
+ * The state is kept in `state`, which should be stored in the node and used for a single collection.
+ */
+GEN(S) S const& delta_collection(ARGS, device_t parent, typename S::value_type const& value, delta_collection_state<S>& state) { CODE PROFILE_CODE
+    using T = typename S::value_type;
+    nbr(CALL, set_delta<T>{}, [&](field<set_delta<T>> x){
+        state.self(value);
+        std::vector<device_t> children;
+        for (device_t id : fcpp::details::get_ids(x)) if (id != node.uid) {
+            set_delta<T> const& d = fcpp::details::self(x, id);
+            if (d.parent == node.uid) {
+                children.push_back(id);
+                state.apply(id, d);
+            }
+        }
+        state.retain(children);
+        if (parent == node.uid) return state.commit(parent, 0, false);
+        return state.commit(parent, fcpp::details::self(x, parent).ack(node.uid));
+    });
+    return state.set();
+}
+//! @brief Export list for delta_collection.
+GEN_EXPORT(S) delta_collection_t = export_list<set_delta<typename S::value_type>>;
+
+
 //! @brief Computes a field of random doubles according to a given distribution.
-GEN(T) field<real_t> rand_hood(ARGS, T&& dist) {
+GEN(T) field<real_t> rand_hood(ARGS, T&& dist) { PROFILE_CODE
     return map_hood([&](device_t){
         return dist(node.generator());
     }, node.nbr_uid());
 }
 
+/**
+ * @brief Computes a field of random doubles according to a given distribution, filled at once.
+ *
+ * Equivalent in distribution to `rand_hood`, drawing a single key from the node generator
+ * and filling the field through `field_random` (for uniform, Weibull and exponential distributions).
+ */
+GEN(T) field<real_t> fast_rand_hood(ARGS, T const& dist) { PROFILE_CODE
+    std::vector<device_t> ids = fcpp::details::get_ids(node.nbr_uid());
+    std::vector<real_t> vals(ids.size() + 1);
+    field_random::fill(vals.data(), vals.size(), std::uniform_int_distribution<uint64_t>{}(node.generator()), dist);
+    return fcpp::details::make_field(std::move(ids), std::move(vals));
+}
+
 
 } // coordination
 
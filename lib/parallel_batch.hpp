@@ -0,0 +1,225 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file parallel_batch.hpp
+ * @brief Multi-threaded execution of batch simulations, with plots merged deterministically in sequence order.
+ */
+
+#ifndef FCPP_PARALLEL_BATCH_H_
+#define FCPP_PARALLEL_BATCH_H_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lib/fcpp.hpp"
+#include "lib/result_writer.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+/**
+ * @brief Plotter recording the rows of a single run, to be replayed later into an actual plotter.
+ *
+ * Used as `plot_type` of the simulations run by `parallel_run`, so that every worker thread
+ * can log into its own shard without contention on the shared plotter.
+ *
+ * @param P The type of the actual plotter.
+ */
+template <typename P>
+class plot_shard {
+  public:
+    //! @brief Function feeding a plotter with the rows of a group of a result file.
+    using replayer_t = std::function<void(P&, result_reader::group const&)>;
+
+    //! @brief Records a row for later replay.
+    template <typename R>
+    plot_shard& operator<<(R const& row) {
+        m_rows.emplace_back([row](P& p){
+            p << row;
+        });
+        if (not m_replayer) {
+            m_replayer = [](P& p, result_reader::group const& g){
+                for (size_t r = 0; r < g.rows; ++r) p << read_row<R>(g, r);
+            };
+            m_columns = column_names<R>();
+        }
+        return *this;
+    }
+
+    //! @brief Records a function feeding the plotter, for later replay.
+    void append(std::function<void(P&)> f) {
+        m_rows.push_back(std::move(f));
+    }
+
+    //! @brief A function replaying groups of rows of the type recorded (empty if no row was recorded).
+    replayer_t const& replayer() const {
+        return m_replayer;
+    }
+
+    //! @brief The names of the columns of the rows recorded (empty if no row was recorded).
+    std::vector<std::string> const& columns() const {
+        return m_columns;
+    }
+
+    //! @brief Replays the recorded rows into a plotter, emptying the shard.
+    void flush(P& p) {
+        for (auto const& f : m_rows) f(p);
+        m_rows.clear();
+    }
+
+    //! @brief Whether the shard holds no rows.
+    bool empty() const {
+        return m_rows.empty();
+    }
+
+  private:
+    //! @brief The recorded rows, as replay functions.
+    std::vector<std::function<void(P&)>> m_rows;
+    //! @brief Function replaying groups of rows of the type recorded.
+    replayer_t m_replayer;
+    //! @brief The names of the columns of the rows recorded.
+    std::vector<std::string> m_columns;
+};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Notifies a plotter of the end of a run (for plotters supporting it).
+    template <typename P>
+    auto end_run(P& p, size_t i, int) -> decltype(p.end_run(i), void()) {
+        p.end_run(i);
+    }
+
+    //! @brief Notifies a plotter of the end of a run (for other plotters).
+    template <typename P>
+    void end_run(P&, size_t, long) {}
+}
+//! @endcond
+
+
+//! @brief Collects shards from concurrent runs, flushing them into a plotter in sequence order.
+template <typename P>
+class ordered_merger {
+  public:
+    //! @brief Constructor given the plotter to be fed.
+    ordered_merger(P& p) : m_plotter(p) {}
+
+    //! @brief Hands over the shard produced by the run with a given index in the sequence.
+    void push(size_t i, plot_shard<P>&& s) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.emplace(i, std::move(s));
+        // only the contiguous prefix of completed runs can be flushed
+        while (not m_pending.empty() and m_pending.begin()->first == m_next) {
+            m_pending.begin()->second.flush(m_plotter);
+            details::end_run(m_plotter, m_next, 0);
+            m_pending.erase(m_pending.begin());
+            ++m_next;
+        }
+    }
+
+  private:
+    //! @brief The plotter to be fed.
+    P& m_plotter;
+    //! @brief Lock for the pending shards.
+    std::mutex m_mutex;
+    //! @brief Shards of completed runs waiting for their predecessors.
+    std::map<size_t, plot_shard<P>> m_pending;
+    //! @brief Index of the next run to be flushed.
+    size_t m_next = 0;
+};
+
+
+/**
+ * @brief View of the elements of a sequence with indices `start`, `start + step`, `start + 2*step`...
+ *
+ * Used to split a sweep into disjoint shards (e.g. among processes): since consecutive elements
+ * of a sequence usually vary in one parameter only, strided shards cover every parameter range
+ * and have a similar computational load.
+ *
+ * @param S The type of the sequence.
+ */
+template <typename S>
+class strided_sequence {
+  public:
+    //! @brief Constructor given the sequence, the first index and the step.
+    strided_sequence(S const& sequence, size_t start, size_t step) : m_sequence(sequence), m_start(start), m_step(std::max<size_t>(step, 1)) {}
+
+    //! @brief The number of elements.
+    size_t size() const {
+        return m_start < m_sequence.size() ? (m_sequence.size() - m_start + m_step - 1) / m_step : 0;
+    }
+
+    //! @brief The element with a given index.
+    decltype(auto) operator[](size_t i) const {
+        return m_sequence[m_start + i * m_step];
+    }
+
+  private:
+    //! @brief The sequence.
+    S const& m_sequence;
+    //! @brief The first index.
+    size_t m_start;
+    //! @brief The step between indices.
+    size_t m_step;
+};
+
+
+/**
+ * @brief Runs a sequence of simulations on a pool of threads.
+ *
+ * Threads pick the next pending run from a shared counter, so that load is balanced regardless
+ * of the duration of single runs. Every run logs into the `plot_shard` of its worker, which
+ * is then merged into `plotter` in sequence order: the resulting plot is identical to the
+ * one of a serial `batch::run`. Plotters with an `end_run(i)` member are notified after the rows
+ * of run `i` have been merged. The sequence must provide an `option::plotter` value
+ * of type `plot_shard<P>*`, which is overwritten for every run.
+ *
+ * @param T The component type (e.g. `component::batch_simulator<...>`).
+ * @param plotter The plotter to be fed with the rows of every run.
+ * @param sequence The tagged tuple sequence of initialisation values.
+ * @param threads The number of worker threads (defaults to the available cores).
+ * @param cached Function filling the shard of a run from a cache, returning whether it did (the run is then skipped).
+ */
+template <typename T, typename P, typename S>
+void parallel_run(T, P& plotter, S const& sequence, size_t threads = std::thread::hardware_concurrency(), std::function<bool(size_t, plot_shard<P>&)> const& cached = {}) {
+    using net_t = typename T::net;
+    threads = std::max<size_t>(1, std::min<size_t>(threads, sequence.size()));
+    std::atomic<size_t> next{0};
+    ordered_merger<P> merger(plotter);
+    auto worker = [&](){
+        plot_shard<P> shard;
+        for (size_t i = next++; i < sequence.size(); i = next++) {
+            if (not (cached and cached(i, shard))) {
+                auto init_v = sequence[i];
+                common::get<component::tags::plotter>(init_v) = &shard;
+                net_t network{init_v};
+                network.run();
+            }
+            merger.push(i, std::move(shard));
+            shard = plot_shard<P>{};
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+}
+
+
+} // batch
+
+} // fcpp
+
+#endif // FCPP_PARALLEL_BATCH_H_
@@ -12,6 +12,7 @@
 #include "lib/component/calculus.hpp"
 #include "lib/option/distribution.hpp"
 
+#include "lib/bundled_spawn.hpp"
 #include "lib/generals.hpp"
 #include "lib/termination.hpp"
 #include "lib/simulation_setup.hpp"
@@ -62,54 +63,66 @@ FUN common::option<message> get_message(ARGS) {
 }
 
 
+//! @brief Counts the rounds, and backs off the round rate of idle devices (running no process, with a stable neighbourhood).
+FUN void adaptive_round(ARGS, bool active) {
+    node.storage(tags::round_count{}) += 1;
+    if (not adaptive_rounds) return;
+    round_backoff& b = node.storage(tags::backoff_log{});
+    b.update(fcpp::details::get_ids(node.nbr_uid()), active, max_backoff);
+    // the schedule keeps its planned times, which are delayed by the intervals skipped so far
+    node.next_time(b.next_time(node.current_time(), node.next_time()));
+}
+
+
 //! @brief Message bytes overhead fixed and per process due to the propagation shape.
 template <template<class> class T>
 class topological_overhead;
 
-//! @brief Makes test for spherical processes.
-GEN(T) void spherical_test(ARGS, common::option<message> const& m, T, int render = -1) { CODE
+//! @brief Makes test for spherical processes, returning whether processes are running.
+GEN(T) bool spherical_test(ARGS, common::option<message> const& m, T, int render = -1) { CODE PROFILE_CODE
     // clear up stats data
     node.storage(tags::proc_data{}).clear();
     node.storage(tags::proc_data{}).push_back(color::hsva(0, 0, 0.3, 1));
 
+#ifdef BUNDLE
+    bundled_spawn(CALL, tags::spherical<T>{}, m, 2.5, render, 0);
+#else
     spawn_profiler(CALL, tags::spherical<T>{}, [&](message const& m){
         status s = node.uid == m.to ? status::terminated_output : status::internal;
         return make_tuple(node.current_time(), s);
-    }, m, 2.5, render, 0, 0);
+    }, m, 2.5, render, 0, proc_budget);
+#endif
+    return node.storage(tags::proc_data{}).size() > 1;
 }
-FUN_EXPORT spherical_test_t = export_list<spawn_profiler_t>;
+FUN_EXPORT spherical_test_t = export_list<spawn_profiler_t, bundled_spawn_t>;
 
 
-//! @brief Makes test for tree processes.
-GEN(T,S) void tree_test(ARGS, common::option<message> const& m, device_t parent, S const& below, size_t set_size, T, int render = -1) { CODE
+//! @brief Makes test for tree processes (given the topology and termination tags, e.g. `tree<ispp>`), returning whether processes are running.
+GEN(T,S) bool tree_test(ARGS, common::option<message> const& m, device_t parent, S const& below, size_t tree_size, T, int render = -1) { CODE PROFILE_CODE
     // clear up stats data
     node.storage(tags::proc_data{}).clear();
     node.storage(tags::proc_data{}).push_back(color::hsva(0, 0, 0.3, 1));
 
-    spawn_profiler(CALL, tags::tree<T>{}, [&](message const& m){
+    spawn_profiler(CALL, T{}, [&](message const& m){
         bool source_path = any_hood(CALL, nbr(CALL, parent) == node.uid) or node.uid == m.from;
+        meter_export(CALL, m, parent);
         bool dest_path = below.count(m.to) > 0;
         status s = node.uid == m.to ? status::terminated_output :
                    source_path or dest_path ? status::internal : status::external_deprecated;
         return make_tuple(node.current_time(), s);
-    }, m, 0.3, render, set_size + 2*sizeof(trace_t) + sizeof(real_t) + sizeof(device_t), sizeof(trace_t));
+    }, m, 0.3, render, tree_size, proc_budget);
+    return node.storage(tags::proc_data{}).size() > 1;
 }
 //! @brief Exports for the main function.
 FUN_EXPORT tree_test_t = export_list<spawn_profiler_t>;
 
 
-#ifdef BLOOM
-//! @brief The type for a set of devices.
-using set_t = bloom_filter<2,256>;
-#else
-//! @brief The type for a set of devices.
-using set_t = std::unordered_set<device_t>;
-#endif
-
 //! @brief Main case study function.
-MAIN() {
+MAIN() { PROFILE_ROUND
     // import tags for convenience
     using namespace tags;
+    // stats on the messages actually sent
+    wire_stats(CALL);
     // basic node rendering
     #ifdef NOTREE
         bool is_src = false;
@@ -120,45 +133,76 @@ MAIN() {
     bool highlight = is_src or node.uid == message_sender or node.uid == message_receiver;
     node.storage(node_shape{}) = is_src ? shape::star : node.uid == message_receiver ? shape::icosahedron : highlight ? shape::cube : shape::sphere;
     node.storage(node_size{}) = is_src ? 30 : highlight ? 20 : 10;
-    // random walk
+    // random walk (skipped under a static topology)
     size_t l = node.storage(side{});
     if (highlight) {
         if (is_src) node.position() = make_vec(l/2, l/2, 20);
         if (node.uid == message_sender) node.position() = make_vec(l/4, l/4, 20);
         if (node.uid == message_receiver) node.position() = make_vec(3*l/4, 3*l/4, 20);
-    } else rectangle_walk(CALL, make_vec(0,0,20), make_vec(l,l,20), node.storage(speed{}) * comm / period, 1);
+    } else if (node.storage(speed{}) > 0) rectangle_walk(CALL, make_vec(0,0,20), make_vec(l,l,20), node.storage(speed{}) * comm / period, 1);
     // standard message from message_sender to message_receiver after time 10
     common::option<message> m = get_message(CALL);
+    // whether the device runs any process
+    bool active = false;
 #ifndef NOSPHERE
     // tests spherical processes with legacy termination
-    spherical_test(CALL, m, legacy{});
-    spherical_test(CALL, m, share{}, 0); // central color
-    spherical_test(CALL, m, ispp{},  1); // left color
-    spherical_test(CALL, m, wispp{}, 2); // right color
+    active |= spherical_test(CALL, m, legacy{});
+    active |= spherical_test(CALL, m, share{}, 0); // central color
+    active |= spherical_test(CALL, m, ispp{},  1); // left color
+    active |= spherical_test(CALL, m, wispp{}, 2); // right color
 #endif
 #ifndef NOTREE
     // spanning tree definition
-    device_t parent = flex_parent(CALL, is_src, comm);
+    tuple<real_t, device_t> parent_export;
+    device_t parent = flex_parent(CALL, is_src, comm, parent_export);
+    size_t parent_size = sent_bytes(CALL, parent_export);
     // routing sets along the tree
-    set_t below = parent_collection(CALL, parent, set_t{node.uid}, [](set_t x, set_t const& y){
 #ifdef BLOOM
-        x.insert(y);
+    set_t const& below = counting_collection(CALL, parent, set_t{bloom_hashes, bloom_bits, {node.uid}}, node.storage(below_state{}));
+    size_t tree_size = sent_bytes(CALL, below) + sent_bytes(CALL, parent);
 #else
-        x.insert(y.begin(), y.end());
+    set_t const& below = delta_collection(CALL, parent, node.uid, node.storage(below_state{}));
+    size_t tree_size = sizeof(trace_t) + node.storage(below_state{}).export_size();
+    node.storage(export_log{}).wire(tree_size);
 #endif
-        return x;
-    });
-    common::osstream os;
-    os << below;
+    tree_size += parent_size;
     // test tree processes with legacy termination
-    tree_test(CALL, m, parent, below, os.size(), legacy{});
-    tree_test(CALL, m, parent, below, os.size(), share{}, 0); // central color
-    tree_test(CALL, m, parent, below, os.size(), ispp{},  1); // left color
-    tree_test(CALL, m, parent, below, os.size(), wispp{}, 2); // right color
+    active |= tree_test(CALL, m, parent, below, tree_size, tree<legacy>{});
+    active |= tree_test(CALL, m, parent, below, tree_size, tree<share>{}, 0); // central color
+    active |= tree_test(CALL, m, parent, below, tree_size, tree<ispp>{},  1); // left color
+    active |= tree_test(CALL, m, parent, below, tree_size, tree<wispp>{}, 2); // right color
+#ifdef COSIM
+    // routing sets along the same tree exploiting Bloom filters
+    bloom_set_t const& bloom_below = counting_collection(CALL, parent, bloom_set_t{bloom_hashes, bloom_bits, {node.uid}}, node.storage(bloom_state{}));
+    size_t bloom_size = sent_bytes(CALL, bloom_below) + sent_bytes(CALL, parent) + parent_size;
+    // test tree processes exploiting Bloom filters
+    active |= tree_test(CALL, m, parent, bloom_below, bloom_size, bloom<legacy>{});
+    active |= tree_test(CALL, m, parent, bloom_below, bloom_size, bloom<share>{});
+    active |= tree_test(CALL, m, parent, bloom_below, bloom_size, bloom<ispp>{});
+    active |= tree_test(CALL, m, parent, bloom_below, bloom_size, bloom<wispp>{});
 #endif
+#endif
+    // adaptive round schedule
+    adaptive_round(CALL, active);
 }
+#ifdef BLOOM
+//! @brief Exports for the collection of routing sets.
+FUN_EXPORT below_collection_t = counting_collection_t<device_t>;
+#else
+//! @brief Exports for the collection of routing sets.
+FUN_EXPORT below_collection_t = delta_collection_t<set_t>;
+#endif
+
+#ifdef COSIM
+//! @brief Exports for the collection of Bloom filter routing sets.
+FUN_EXPORT bloom_collection_t = counting_collection_t<device_t>;
+#else
+//! @brief Exports for the collection of Bloom filter routing sets (none).
+FUN_EXPORT bloom_collection_t = export_list<>;
+#endif
+
 //! @brief Exports for the main function.
-struct main_t : public export_list<rectangle_walk_t<3>, spherical_test_t, flex_parent_t, real_t, parent_collection_t<set_t>, tree_test_t> {};
+struct main_t : public export_list<wire_stats_t, rectangle_walk_t<3>, spherical_test_t, flex_parent_t, real_t, below_collection_t, bloom_collection_t, tree_test_t> {};
 
 
 } // coordination
@@ -0,0 +1,237 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file profiler.hpp
+ * @brief Opt-in profiler of aggregate functions by call point (enabled by the PROFILE flag).
+ *
+ * Functions are marked by `PROFILE_CODE` (after `CODE`, if present) and rounds by `PROFILE_ROUND`.
+ * With the PROFILE flag, wall time and heap allocations (see `alloc_counter.hpp`) of every marked
+ * function are accumulated across nodes and rounds by stack of call points, and written at exit as
+ * folded stacks (for flamegraphs) and as a Chrome trace (one event for every stack). Without the
+ * flag, markers expand to nothing.
+ */
+
+#ifndef FCPP_PROFILER_H_
+#define FCPP_PROFILER_H_
+
+#ifdef PROFILE
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "lib/alloc_counter.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the profiler of aggregate functions.
+namespace profiler {
+
+//! @brief Measures of a stack of calls.
+struct frame {
+    //! @brief The name of the function of the last call.
+    char const* name;
+    //! @brief The call point of the last call (or `npos` if none).
+    size_t point;
+    //! @brief The index of the parent frame.
+    size_t parent;
+    //! @brief The total nanoseconds spent (including children).
+    double ns = 0;
+    //! @brief The total heap allocations performed (including children).
+    size_t allocs = 0;
+    //! @brief The number of calls.
+    size_t calls = 0;
+    //! @brief The indices of the children frames.
+    std::vector<size_t> children;
+
+    //! @brief Missing call point.
+    static constexpr size_t npos = size_t(-1);
+
+    //! @brief Whether the last call has a given function name and call point.
+    bool is(char const* n, size_t p) const {
+        return point == p and (name == n or std::strcmp(name, n) == 0);
+    }
+
+    //! @brief The label of the last call.
+    std::string label() const {
+        return point == npos ? std::string(name) : std::string(name) + ":" + std::to_string(point);
+    }
+};
+
+//! @brief Tree of the stacks of calls, rooted in frame zero.
+class tree {
+  public:
+    //! @brief Constructor with the root frame only.
+    tree() : m_frames{{"", frame::npos, 0}} {}
+
+    //! @brief The child of a frame for a given function name and call point (created if missing).
+    size_t child(size_t f, char const* name, size_t point) {
+        for (size_t c : m_frames[f].children) if (m_frames[c].is(name, point)) return c;
+        m_frames[f].children.push_back(m_frames.size());
+        m_frames.push_back({name, point, f});
+        return m_frames.size() - 1;
+    }
+
+    //! @brief Adds the measures of another tree.
+    void merge(tree const& t, size_t from = 0, size_t to = 0) {
+        frame const& s = t.m_frames[from];
+        m_frames[to].ns += s.ns;
+        m_frames[to].allocs += s.allocs;
+        m_frames[to].calls += s.calls;
+        for (size_t c : s.children) merge(t, c, child(to, t.m_frames[c].name, t.m_frames[c].point));
+    }
+
+    //! @brief Writes the self time (or allocations) of every stack in folded format.
+    void folded(std::ostream& o, bool allocs, size_t f = 0, std::string const& stack = "") const {
+        frame const& x = m_frames[f];
+        double self = allocs ? x.allocs : x.ns;
+        for (size_t c : x.children) self -= allocs ? m_frames[c].allocs : m_frames[c].ns;
+        if (f > 0 and self > 0) o << stack << " " << size_t(self) << "\n";
+        for (size_t c : x.children) folded(o, allocs, c, f > 0 ? stack + ";" + m_frames[c].label() : m_frames[c].label());
+    }
+
+    //! @brief Writes every stack as a complete event of a Chrome trace, laying out children one after the other.
+    void chrome(std::ostream& o, size_t f = 0, double start = 0, bool first = true) const {
+        frame const& x = m_frames[f];
+        if (f > 0) {
+            o << (first ? "\n" : ",\n") << "{\"name\": \"" << x.label() << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << start / 1000
+              << ", \"dur\": " << x.ns / 1000 << ", \"args\": {\"calls\": " << x.calls << ", \"allocs\": " << x.allocs << "}}";
+            first = false;
+        }
+        for (size_t c : x.children) {
+            chrome(o, c, start, first);
+            first = false;
+            start += m_frames[c].ns;
+        }
+    }
+
+    //! @brief Access to a frame.
+    frame& operator[](size_t f) {
+        return m_frames[f];
+    }
+
+  private:
+    //! @brief The frames.
+    std::vector<frame> m_frames;
+};
+
+//! @brief Collects the trees of every thread, writing them at exit.
+class registry {
+  public:
+    //! @brief Adds the measures of a thread.
+    void merge(tree const& t) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tree.merge(t);
+    }
+
+    //! @brief Destructor, writing the output files (prefixed by the `FCPP_PROFILE` environment variable, or `plot/profile`).
+    ~registry() {
+        char const* env = std::getenv("FCPP_PROFILE");
+        std::string prefix = env ? env : std::filesystem::is_directory("plot") ? "plot/profile" : "profile";
+        std::ofstream time(prefix + ".folded");
+        m_tree.folded(time, false);
+        std::ofstream allocs(prefix + ".allocs.folded");
+        m_tree.folded(allocs, true);
+        std::ofstream chrome(prefix + ".json");
+        chrome << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        m_tree.chrome(chrome);
+        chrome << "\n]}\n";
+        std::cerr << "profile written to " << prefix << ".{folded,allocs.folded,json}" << (alloc_counter::active ? "" : " (allocations not counted)") << std::endl;
+    }
+
+    //! @brief The global instance.
+    static registry& instance() {
+        static registry r;
+        return r;
+    }
+
+  private:
+    //! @brief Lock for merging.
+    std::mutex m_mutex;
+    //! @brief The measures of the terminated threads.
+    tree m_tree;
+};
+
+//! @brief Tree of the current thread, merged into the registry when the thread terminates.
+struct thread_tree : tree {
+    //! @brief Constructor, ensuring that the registry outlives the tree.
+    thread_tree() {
+        registry::instance();
+    }
+
+    //! @brief Destructor, merging the measures.
+    ~thread_tree() {
+        registry::instance().merge(*this);
+    }
+
+    //! @brief The current frame.
+    size_t current = 0;
+
+    //! @brief The tree of the current thread.
+    static thread_tree& instance() {
+        static thread_local thread_tree t;
+        return t;
+    }
+};
+
+//! @brief Measures a call, from construction to destruction.
+class scope {
+  public:
+    //! @brief Constructor given a function name and a call point (the name must outlive the program).
+    scope(char const* name, size_t call_point = frame::npos) : m_tree(thread_tree::instance()), m_parent(m_tree.current), m_frame(m_tree.current = m_tree.child(m_parent, name, call_point)) {}
+
+    //! @brief Destructor, adding up measures.
+    ~scope() {
+        frame& f = m_tree[m_frame];
+        f.ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+        f.allocs += m_allocs.allocations();
+        f.calls += 1;
+        m_tree.current = m_parent;
+    }
+
+  private:
+    //! @brief The tree of the current thread.
+    thread_tree& m_tree;
+    //! @brief The caller frame.
+    size_t m_parent;
+    //! @brief The frame of the call.
+    size_t m_frame;
+    //! @brief Allocations at construction.
+    alloc_counter::scope m_allocs;
+    //! @brief Time of construction.
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+};
+
+}
+
+}
+
+//! @brief Profiles the current function (requires a `call_point` argument).
+#define PROFILE_CODE fcpp::profiler::scope fcpp_profile_scope(__func__, call_point);
+//! @brief Profiles the current round.
+#define PROFILE_ROUND fcpp::profiler::scope fcpp_profile_scope("round");
+//! @brief Counts heap allocations for the profiler (to be expanded once at global scope, in the file containing `main`).
+#define PROFILE_ALLOCATIONS FCPP_COUNT_ALLOCATIONS
+
+#else
+
+//! @brief Profiles the current function (requires a `call_point` argument).
+#define PROFILE_CODE
+//! @brief Profiles the current round.
+#define PROFILE_ROUND
+//! @brief Counts heap allocations for the profiler (to be expanded once at global scope, in the file containing `main`).
+#define PROFILE_ALLOCATIONS static_assert(true)
+
+#endif
+
+#endif // FCPP_PROFILER_H_
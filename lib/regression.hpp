@@ -0,0 +1,231 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file regression.hpp
+ * @brief Measures of end-to-end simulation throughput, compared against a baseline with tolerances.
+ */
+
+#ifndef FCPP_REGRESSION_H_
+#define FCPP_REGRESSION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define FCPP_REGRESSION_RUSAGE
+#endif
+
+#include "lib/fcpp.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+//! @brief Counters of the work performed by counted programs.
+struct work_counter {
+    //! @brief The number of rounds executed.
+    std::atomic<size_t> rounds{0};
+    //! @brief The number of bytes exported.
+    std::atomic<size_t> bytes{0};
+    //! @brief The number of neighbour exports processed by rounds.
+    std::atomic<size_t> exports{0};
+
+    //! @brief The global instance.
+    static work_counter& instance() {
+        static work_counter c;
+        return c;
+    }
+};
+
+/**
+ * @brief Program running another one, while counting rounds, bytes exported and neighbour exports processed in the global `work_counter`.
+ *
+ * The bytes of the message sent by a round are available in the following round, requiring the
+ * `message_size<true>` option. The neighbour exports processed by a round are those in the domain
+ * of its neighbourhood (excluding the device itself).
+ *
+ * @param P The program to be run.
+ */
+template <typename P>
+struct counted_program {
+    //! @brief Runs a round.
+    template <typename node_t>
+    void operator()(node_t& node, times_t t) {
+        P{}(node, t);
+        work_counter& c = work_counter::instance();
+        c.rounds += 1;
+        c.bytes += node.msg_size();
+        std::vector<device_t> const& ids = fcpp::details::get_ids(node.nbr_uid());
+        c.exports += ids.size() - std::count(ids.begin(), ids.end(), node.uid);
+    }
+};
+
+}
+
+
+//! @brief The peak resident set size of the process in kilobytes (zero if not available).
+inline size_t peak_rss_kb() {
+#ifdef FCPP_REGRESSION_RUSAGE
+    struct rusage u;
+    getrusage(RUSAGE_SELF, &u);
+#ifdef __APPLE__
+    return u.ru_maxrss / 1024;
+#else
+    return u.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * @brief Baseline of named measures for named scenarios, with relative tolerances by measure.
+ *
+ * Stored as a JSON object with a `tolerance` object mapping measures to relative tolerances,
+ * and an object for every scenario mapping measures to values. Measures whose name ends in
+ * `_per_s` regress when they decrease, `rounds`, `events` and `bytes` (which are deterministic)
+ * when they change, and the others when they increase. Scenarios and measures missing from the
+ * baseline fail the comparison.
+ */
+class regression_baseline {
+  public:
+    //! @brief The measures of a scenario.
+    using measures_t = std::map<std::string, double>;
+
+    //! @brief Constructor loading a baseline file (empty if the file does not exist).
+    regression_baseline(std::string const& path) : m_path(path) {
+        std::ifstream in(path);
+        if (not in) return;
+        std::stringstream ss;
+        ss << in.rdbuf();
+        std::string s = ss.str();
+        size_t i = 0;
+        expect(s, i, '{');
+        while (peek(s, i) != '}') {
+            std::string name = read_string(s, i);
+            expect(s, i, ':');
+            measures_t& m = name == "tolerance" ? m_tolerance : m_scenarios[name];
+            expect(s, i, '{');
+            while (peek(s, i) != '}') {
+                std::string key = read_string(s, i);
+                expect(s, i, ':');
+                m[key] = read_number(s, i);
+                if (peek(s, i) == ',') ++i;
+            }
+            ++i;
+            if (peek(s, i) == ',') ++i;
+        }
+    }
+
+    //! @brief Compares the measures of a scenario against the baseline, printing the outcome and returning whether no measure regressed.
+    bool compare(std::string const& scenario, measures_t const& m, std::ostream& o) const {
+        auto it = m_scenarios.find(scenario);
+        if (it == m_scenarios.end()) {
+            o << "FAIL " << scenario << ": no baseline in " << m_path << " (to be recorded with --update on the reference machine)" << std::endl;
+            return false;
+        }
+        bool ok = true;
+        for (auto const& x : m) {
+            auto b = it->second.find(x.first);
+            if (b == it->second.end()) {
+                o << "FAIL " << scenario << " " << x.first << ": " << x.second << " (no baseline)" << std::endl;
+                ok = false;
+                continue;
+            }
+            auto t = m_tolerance.find(x.first);
+            double tol = t == m_tolerance.end() ? 0 : t->second;
+            double base = b->second;
+            bool lower = x.second < base * (1 - tol);
+            bool higher = x.second > base * (1 + tol);
+            bool per_s = x.first.size() > 6 and x.first.substr(x.first.size() - 6) == "_per_s";
+            bool exact = x.first == "rounds" or x.first == "events" or x.first == "bytes";
+            bool fail = per_s ? lower : exact ? lower or higher : higher;
+            ok = ok and not fail;
+            o << (fail ? "FAIL " : "ok   ") << scenario << " " << x.first << ": " << x.second << " (baseline " << base << ", tolerance " << tol * 100 << "%)" << std::endl;
+        }
+        return ok;
+    }
+
+    //! @brief Replaces the measures of a scenario, saving the baseline.
+    void update(std::string const& scenario, measures_t const& m) {
+        m_scenarios[scenario] = m;
+        std::ofstream out(m_path);
+        if (not out) throw std::runtime_error("cannot write baseline " + m_path);
+        out.precision(10);
+        out << "{\n";
+        write(out, "tolerance", m_tolerance, m_scenarios.empty());
+        for (auto it = m_scenarios.begin(); it != m_scenarios.end(); ++it)
+            write(out, it->first, it->second, std::next(it) == m_scenarios.end());
+        out << "}\n";
+    }
+
+  private:
+    //! @brief Writes a named object of measures.
+    static void write(std::ostream& o, std::string const& name, measures_t const& m, bool last) {
+        o << "    \"" << name << "\": {";
+        for (auto it = m.begin(); it != m.end(); ++it)
+            o << (it == m.begin() ? "\n" : ",\n") << "        \"" << it->first << "\": " << it->second;
+        o << (m.empty() ? "}" : "\n    }") << (last ? "\n" : ",\n");
+    }
+
+    //! @brief The next non-space character.
+    static char peek(std::string const& s, size_t& i) {
+        while (i < s.size() and std::isspace(s[i])) ++i;
+        if (i == s.size()) throw std::runtime_error("unexpected end of baseline");
+        return s[i];
+    }
+
+    //! @brief Skips a given character.
+    static void expect(std::string const& s, size_t& i, char c) {
+        if (peek(s, i) != c) throw std::runtime_error(std::string("expected '") + c + "' in baseline");
+        ++i;
+    }
+
+    //! @brief Reads a string.
+    static std::string read_string(std::string const& s, size_t& i) {
+        expect(s, i, '"');
+        size_t j = s.find('"', i);
+        if (j == std::string::npos) throw std::runtime_error("unterminated string in baseline");
+        std::string r = s.substr(i, j - i);
+        i = j + 1;
+        return r;
+    }
+
+    //! @brief Reads a number.
+    static double read_number(std::string const& s, size_t& i) {
+        peek(s, i);
+        size_t n;
+        double r = std::stod(s.substr(i), &n);
+        i += n;
+        return r;
+    }
+
+    //! @brief The path of the baseline file.
+    std::string m_path;
+    //! @brief The relative tolerances by measure.
+    measures_t m_tolerance;
+    //! @brief The measures by scenario.
+    std::map<std::string, measures_t> m_scenarios;
+};
+
+
+}
+
+#endif // FCPP_REGRESSION_H_
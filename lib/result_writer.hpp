@@ -0,0 +1,507 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file result_writer.hpp
+ * @brief Streaming writer (and reader) of the rows logged by batch runs, in a binary columnar format or as CSV.
+ */
+
+#ifndef FCPP_RESULT_WRITER_H_
+#define FCPP_RESULT_WRITER_H_
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FCPP_RESULT_MMAP
+#endif
+
+#include "lib/fcpp.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief Output formats of a result writer.
+enum class result_format { binary, csv };
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Magic number at the start of binary result files.
+    constexpr char result_magic[8] = {'F','C','P','P','C','O','L','1'};
+    //! @brief Magic number at the end of complete binary result files.
+    constexpr char result_end[8] = {'F','C','P','P','E','N','D','1'};
+    //! @brief Marker at the start of every row group.
+    constexpr uint64_t group_marker = 0x4652475550524f47;
+
+    //! @brief Type codes of columns.
+    enum column_type : uint64_t { real_column = 'd', int_column = 'i', uint_column = 'u' };
+
+    //! @brief A column value, as stored in binary files.
+    union column_value {
+        double d;
+        int64_t i;
+        uint64_t u;
+    };
+
+    //! @brief The type code of a column type.
+    template <typename T>
+    constexpr column_type column_code() {
+        if (std::is_floating_point<T>::value or not std::is_arithmetic<T>::value) return real_column;
+        return std::is_signed<T>::value ? int_column : uint_column;
+    }
+
+    //! @brief Converts a value into a column value.
+    template <typename T>
+    column_value column_cast(T const& x) {
+        column_value v;
+        if constexpr (not std::is_arithmetic<T>::value) v.d = std::numeric_limits<double>::quiet_NaN();
+        else if constexpr (std::is_floating_point<T>::value) v.d = x;
+        else if constexpr (std::is_signed<T>::value) v.i = x;
+        else v.u = x;
+        return v;
+    }
+
+    //! @brief Strips namespaces from a type name.
+    inline std::string column_name(std::string s) {
+        std::string r;
+        size_t start = 0;
+        for (size_t i = 0; i < s.size(); ++i) {
+            if (s[i] == ':' and i+1 < s.size() and s[i+1] == ':') {
+                r.erase(start);
+                ++i;
+            } else {
+                if (not (std::isalnum(s[i]) or s[i] == '_')) start = r.size() + 1;
+                r += s[i];
+            }
+        }
+        return r;
+    }
+
+    //! @brief Applies a function to name, code and value of every column of a row.
+    template <typename R, typename F, typename... Ss>
+    void for_columns(R const& row, F&& f, common::type_sequence<Ss...>) {
+        [[maybe_unused]] int c[] = {0, (f(column_name(common::type_name<Ss>()), column_code<std::decay_t<decltype(common::get<Ss>(row))>>(), common::get<Ss>(row)), 0)...};
+    }
+
+    //! @brief Applies a function to name, code and value of every column of a row.
+    template <typename R, typename F>
+    void for_columns(R const& row, F&& f) {
+        for_columns(row, f, typename R::tags{});
+    }
+
+    //! @brief Writes an integer to a stream.
+    inline void write_u64(std::ostream& o, uint64_t x) {
+        o.write(reinterpret_cast<char const*>(&x), sizeof(uint64_t));
+    }
+
+    //! @brief Converts a column value into a value.
+    template <typename T>
+    void column_assign(T& x, column_value v) {
+        if constexpr (std::is_floating_point<T>::value) x = v.d;
+        else if constexpr (std::is_arithmetic<T>::value and std::is_signed<T>::value) x = v.i;
+        else if constexpr (std::is_arithmetic<T>::value) x = v.u;
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Reader of binary result files, mapping them in memory where possible.
+ *
+ * Files without a footer (e.g. from interrupted sweeps) are indexed by scanning their groups,
+ * ignoring a truncated last one.
+ */
+class result_reader {
+  public:
+    //! @brief A row group.
+    struct group {
+        //! @brief The offset in the file.
+        uint64_t offset;
+        //! @brief The index of the run.
+        uint64_t run;
+        //! @brief The number of rows.
+        uint64_t rows;
+        //! @brief The values, column-major.
+        details::column_value const* values;
+
+        //! @brief The value of a column in a row, as a double.
+        double value(size_t col, size_t row, uint64_t type) const {
+            details::column_value v = values[col * rows + row];
+            return type == details::real_column ? v.d : type == details::int_column ? double(v.i) : double(v.u);
+        }
+    };
+
+    //! @brief Constructor given a path.
+    result_reader(std::string const& path) {
+        load(path);
+        uint64_t const* w = words(0);
+        if (m_size < 16 or std::memcmp(m_data, details::result_magic, 8) != 0)
+            throw std::runtime_error("not a result file: " + path);
+        size_t pos = 8;
+        uint64_t ncols = w[1];
+        pos += 8;
+        for (uint64_t c = 0; c < ncols; ++c) {
+            m_types.push_back(words(pos)[0]);
+            uint64_t len = words(pos)[1];
+            m_columns.emplace_back(m_data + pos + 16, len);
+            pos += 16 + (len + 7) / 8 * 8;
+        }
+        // indexes groups by scanning, stopping at the footer or at a truncated group
+        while (pos + 24 <= m_size and words(pos)[0] == details::group_marker) {
+            uint64_t rows = words(pos)[2];
+            size_t end = pos + 24 + rows * ncols * 8;
+            if (end > m_size) break;
+            m_groups.push_back({pos, words(pos)[1], rows, reinterpret_cast<details::column_value const*>(m_data + pos + 24)});
+            pos = end;
+        }
+        m_end = pos;
+    }
+
+    //! @brief Destructor, releasing the file.
+    ~result_reader() {
+#ifdef FCPP_RESULT_MMAP
+        if (m_data) munmap(const_cast<char*>(m_data), m_size);
+#endif
+    }
+
+    //! @brief Readers are not copyable.
+    result_reader(result_reader const&) = delete;
+
+    //! @brief The names of the columns.
+    std::vector<std::string> const& columns() const {
+        return m_columns;
+    }
+
+    //! @brief The type codes of the columns.
+    std::vector<uint64_t> const& types() const {
+        return m_types;
+    }
+
+    //! @brief The row groups.
+    std::vector<group> const& groups() const {
+        return m_groups;
+    }
+
+    //! @brief The row group at a given offset (null if none).
+    group const* find(uint64_t offset) const {
+        auto it = std::lower_bound(m_groups.begin(), m_groups.end(), offset, [](group const& g, uint64_t o){
+            return g.offset < o;
+        });
+        return it != m_groups.end() and it->offset == offset ? &*it : nullptr;
+    }
+
+    //! @brief The offset past the last complete group.
+    uint64_t end() const {
+        return m_end;
+    }
+
+  private:
+    //! @brief Maps (or reads) a file in memory.
+    void load(std::string const& path) {
+#ifdef FCPP_RESULT_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open result file " + path);
+        struct stat st;
+        fstat(fd, &st);
+        m_size = st.st_size;
+        void* p = m_size ? mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("cannot map result file " + path);
+        m_data = static_cast<char const*>(p);
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (not in) throw std::runtime_error("cannot open result file " + path);
+        m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m_buffer.resize((m_buffer.size() + 7) / 8 * 8);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+#endif
+    }
+
+    //! @brief The words from a given byte offset.
+    uint64_t const* words(size_t pos) const {
+        return reinterpret_cast<uint64_t const*>(m_data + pos);
+    }
+
+    //! @brief The content of the file.
+    char const* m_data = nullptr;
+    //! @brief The size of the file.
+    size_t m_size = 0;
+#ifndef FCPP_RESULT_MMAP
+    //! @brief The buffer holding the file.
+    std::vector<char> m_buffer;
+#endif
+    //! @brief The names of the columns.
+    std::vector<std::string> m_columns;
+    //! @brief The type codes of the columns.
+    std::vector<uint64_t> m_types;
+    //! @brief The row groups.
+    std::vector<group> m_groups;
+    //! @brief The offset past the last complete group.
+    uint64_t m_end = 0;
+};
+
+
+//! @brief The names of the columns of a row type.
+template <typename R>
+std::vector<std::string> column_names() {
+    std::vector<std::string> v;
+    details::for_columns(R{}, [&](std::string const& name, uint64_t, auto const&){
+        v.push_back(name);
+    });
+    return v;
+}
+
+//! @brief Reads a row of a given type from a row group.
+template <typename R>
+R read_row(result_reader::group const& g, size_t row) {
+    R r;
+    size_t c = 0;
+    details::for_columns(r, [&](std::string const&, uint64_t, auto const& x){
+        details::column_assign(const_cast<std::decay_t<decltype(x)>&>(x), g.values[c++ * g.rows + row]);
+    });
+    return r;
+}
+
+
+/**
+ * @brief Streaming writer of the rows logged by batch runs, one row group per run.
+ *
+ * In the binary format, every value takes 8 bytes and row groups are column-major, so that
+ * a mapped file can be read in place (see `result_reader`). The file starts with the names
+ * and types of the columns, followed by the row groups and a footer indexing them.
+ * Rows are buffered only until the end of their run, when their group is written and flushed:
+ * after a crash, the groups already written can still be read (a footer is then rebuilt by
+ * scanning them). In the CSV format, every row is prefixed by the index of its run.
+ */
+class result_writer {
+  public:
+    //! @brief The format of a path (binary unless it ends in `.csv`).
+    static result_format format_of(std::string const& path) {
+        return path.size() >= 4 and path.substr(path.size()-4) == ".csv" ? result_format::csv : result_format::binary;
+    }
+
+    //! @brief Constructor given a path, and whether to append to its valid groups (binary format only).
+    result_writer(std::string const& path, bool resume = false) : result_writer(path, format_of(path), resume) {}
+
+    //! @brief Constructor given a path, a format, and whether to append to its valid groups (binary format only).
+    result_writer(std::string const& path, result_format format, bool resume = false) : m_format(format) {
+        if (resume and format == result_format::binary and std::filesystem::exists(path)) {
+            uint64_t end;
+            {
+                result_reader r(path);
+                m_columns = r.columns();
+                m_types = r.types();
+                for (auto const& g : r.groups()) m_groups.push_back(g.offset);
+                end = r.end();
+            }
+            // drops the footer or a truncated group
+            std::filesystem::resize_file(path, end);
+            m_data.resize(m_columns.size());
+            m_resumed = true;
+            m_out.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            m_out.seekp(0, std::ios::end);
+        } else m_out.open(path, std::ios::binary | std::ios::trunc);
+        if (not m_out) throw std::runtime_error("cannot open result file " + path);
+        m_out.precision(std::numeric_limits<double>::max_digits10);
+    }
+
+    //! @brief Destructor, completing the file.
+    ~result_writer() {
+        close();
+    }
+
+    //! @brief Appends a row to the current run.
+    template <typename R>
+    result_writer& operator<<(R const& row) {
+        if (m_rows == 0 and not m_checked) schema(row);
+        size_t c = 0;
+        details::for_columns(row, [&](std::string const&, uint64_t, auto const& x){
+            m_data[c++].push_back(details::column_cast(x));
+        });
+        ++m_rows;
+        return *this;
+    }
+
+    //! @brief Closes the current run, writing its rows as a group with a given index and returning its offset (zero for CSV).
+    uint64_t end_run(size_t run) {
+        uint64_t offset = 0;
+        if (m_rows == 0) return offset;
+        if (m_format == result_format::csv) {
+            for (size_t r = 0; r < m_rows; ++r) {
+                m_out << run;
+                for (size_t c = 0; c < m_columns.size(); ++c) {
+                    m_out << ',';
+                    details::column_value v = m_data[c][r];
+                    if (m_types[c] == details::real_column) m_out << v.d;
+                    else if (m_types[c] == details::int_column) m_out << v.i;
+                    else m_out << v.u;
+                }
+                m_out << '\n';
+            }
+        } else {
+            offset = m_out.tellp();
+            m_groups.push_back(offset);
+            details::write_u64(m_out, details::group_marker);
+            details::write_u64(m_out, run);
+            details::write_u64(m_out, m_rows);
+            for (auto const& col : m_data)
+                m_out.write(reinterpret_cast<char const*>(col.data()), col.size() * sizeof(details::column_value));
+        }
+        for (auto& col : m_data) col.clear();
+        m_rows = 0;
+        m_out.flush();
+        return offset;
+    }
+
+    //! @brief Completes the file (further rows are ignored).
+    void close() {
+        if (not m_out.is_open()) return;
+        if (m_format == result_format::binary) {
+            if (not m_checked and not m_resumed) header();
+            uint64_t start = m_out.tellp();
+            for (uint64_t g : m_groups) details::write_u64(m_out, g);
+            details::write_u64(m_out, m_groups.size());
+            details::write_u64(m_out, start);
+            m_out.write(details::result_end, 8);
+        }
+        m_out.close();
+    }
+
+  private:
+    //! @brief Learns the columns from a row, writing the file header (or checking it against the resumed file).
+    template <typename R>
+    void schema(R const& row) {
+        std::vector<std::string> columns;
+        std::vector<uint64_t> types;
+        details::for_columns(row, [&](std::string const& name, uint64_t code, auto const&){
+            columns.push_back(name);
+            types.push_back(code);
+        });
+        m_checked = true;
+        if (m_resumed) {
+            if (columns != m_columns or types != m_types) throw std::runtime_error("rows differ from the columns of the resumed result file");
+            return;
+        }
+        m_columns = columns;
+        m_types = types;
+        m_data.resize(m_columns.size());
+        header();
+    }
+
+    //! @brief Writes the file header.
+    void header() {
+        if (m_format == result_format::csv) {
+            m_out << "run";
+            for (std::string const& n : m_columns) m_out << ",\"" << n << '"';
+            m_out << '\n';
+            return;
+        }
+        m_out.write(details::result_magic, 8);
+        details::write_u64(m_out, m_columns.size());
+        for (size_t c = 0; c < m_columns.size(); ++c) {
+            details::write_u64(m_out, m_types[c]);
+            details::write_u64(m_out, m_columns[c].size());
+            std::string name = m_columns[c];
+            name.resize((name.size() + 7) / 8 * 8, '\0');
+            m_out.write(name.data(), name.size());
+        }
+    }
+
+    //! @brief The output format.
+    result_format m_format;
+    //! @brief The output file.
+    std::ofstream m_out;
+    //! @brief The names of the columns.
+    std::vector<std::string> m_columns;
+    //! @brief The types of the columns.
+    std::vector<uint64_t> m_types;
+    //! @brief The values of the current run, by column.
+    std::vector<std::vector<details::column_value>> m_data;
+    //! @brief The number of rows of the current run.
+    size_t m_rows = 0;
+    //! @brief The offsets of the groups written.
+    std::vector<uint64_t> m_groups;
+    //! @brief Whether the columns have been learnt from a row.
+    bool m_checked = false;
+    //! @brief Whether the writer is appending to an existing file.
+    bool m_resumed = false;
+};
+
+
+/**
+ * @brief Plotter feeding both a plotter and a result writer.
+ *
+ * Used with `parallel_run`, which closes the run of the writer after the rows of every run
+ * have been merged in sequence order.
+ *
+ * @param P The type of the actual plotter.
+ */
+template <typename P>
+class streaming_plotter {
+  public:
+    //! @brief Constructor given the plotter and the writer to be fed.
+    streaming_plotter(P& p, result_writer& w) : m_plotter(p), m_writer(w) {}
+
+    //! @brief Feeds a row.
+    template <typename R>
+    streaming_plotter& operator<<(R const& row) {
+        m_plotter << row;
+        if (not m_muted) m_writer << row;
+        return *this;
+    }
+
+    //! @brief Sets whether rows should be fed to the plotter only (e.g. when replaying them from the results file).
+    void mute(bool muted) {
+        m_muted = muted;
+    }
+
+    //! @brief Closes a run.
+    void end_run(size_t run) {
+        uint64_t offset = m_writer.end_run(run);
+        if (m_listener and offset > 0) m_listener(run, offset);
+    }
+
+    //! @brief Sets a function to be called with the index and group offset of every run written.
+    void listen(std::function<void(size_t, uint64_t)> f) {
+        m_listener = std::move(f);
+    }
+
+  private:
+    //! @brief The plotter.
+    P& m_plotter;
+    //! @brief The writer.
+    result_writer& m_writer;
+    //! @brief Function called when a run is closed.
+    std::function<void(size_t, uint64_t)> m_listener;
+    //! @brief Whether rows are fed to the plotter only.
+    bool m_muted = false;
+};
+
+
+} // batch
+
+} // fcpp
+
+#endif // FCPP_RESULT_WRITER_H_
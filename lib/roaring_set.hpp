@@ -0,0 +1,547 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file roaring_set.hpp
+ * @brief Compressed bitmap set of unsigned integers, in the style of roaring bitmaps.
+ */
+
+#ifndef FCPP_ROARING_SET_H_
+#define FCPP_ROARING_SET_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "lib/simd_bloom.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @cond INTERNAL
+namespace details {
+    /**
+     * @brief The elements of a roaring set sharing the same high bits, as 16-bit low values.
+     *
+     * Values are held either as a sorted array, as a bitmap of 2^16 bits, or as a sorted list
+     * of runs of consecutive values. The representation follows the smallest one as elements
+     * are inserted and removed, with a factor two of hysteresis to avoid thrashing.
+     */
+    template <typename T>
+    struct roaring_chunk {
+        //! @brief The representations of a chunk.
+        enum kind_t : uint8_t { array, bitmap, run };
+
+        //! @brief The number of words of a bitmap.
+        static constexpr size_t words = 1024;
+        //! @brief The maximum number of elements of an array.
+        static constexpr size_t array_max = 4096;
+        //! @brief A low value past the last one.
+        static constexpr uint32_t past = 65536;
+
+        //! @brief The high bits shared by the elements.
+        T key = 0;
+        //! @brief The current representation.
+        uint8_t kind = array;
+        //! @brief The number of elements.
+        uint32_t card = 0;
+        //! @brief The number of runs of consecutive elements.
+        uint32_t runs = 0;
+        //! @brief Sorted values (array) or pairs of first and last values (run).
+        std::vector<uint16_t> data;
+        //! @brief The bits of a bitmap.
+        std::vector<uint64_t> bits;
+
+        //! @brief Whether a value is present.
+        bool contains(uint16_t v) const {
+            switch (kind) {
+              case array:
+                return std::binary_search(data.begin(), data.end(), v);
+              case bitmap:
+                return (bits[v >> 6] >> (v & 63)) & 1;
+              default: {
+                long k = run_before(v);
+                return k >= 0 and v <= data[2*k+1];
+              }
+            }
+        }
+
+        //! @brief The smallest present value not below `v` (`past` if none).
+        uint32_t next(uint32_t v) const {
+            if (v >= past) return past;
+            switch (kind) {
+              case array: {
+                auto it = std::lower_bound(data.begin(), data.end(), v);
+                return it == data.end() ? past : *it;
+              }
+              case bitmap: {
+                size_t i = v >> 6;
+                uint64_t w = bits[i] & (~uint64_t(0) << (v & 63));
+                while (w == 0) {
+                    if (++i == words) return past;
+                    w = bits[i];
+                }
+                return i * 64 + __builtin_ctzll(w);
+              }
+              default: {
+                long k = run_before(v);
+                if (k >= 0 and v <= data[2*k+1]) return v;
+                return size_t(k+1) < data.size()/2 ? data[2*k+2] : past;
+              }
+            }
+        }
+
+        //! @brief Inserts a value, returning whether it was absent.
+        bool insert(uint16_t v) {
+            if (contains(v)) return false;
+            bool l = v > 0 and contains(v-1);
+            bool r = v < past-1 and contains(v+1);
+            switch (kind) {
+              case array:
+                data.insert(std::upper_bound(data.begin(), data.end(), v), v);
+                break;
+              case bitmap:
+                bits[v >> 6] |= uint64_t(1) << (v & 63);
+                break;
+              default: {
+                // run k ends right before v if l, run k+1 starts right after v if r
+                long k = run_before(v);
+                if (l and r) {
+                    data[2*k+1] = data[2*k+3];
+                    data.erase(data.begin() + 2*k+2, data.begin() + 2*k+4);
+                } else if (l) data[2*k+1] = v;
+                else if (r) data[2*k+2] = v;
+                else data.insert(data.begin() + 2*(k+1), {v, v});
+              }
+            }
+            ++card;
+            runs = runs + 1 - l - r;
+            adapt();
+            return true;
+        }
+
+        //! @brief Removes a value, returning whether it was present.
+        bool erase(uint16_t v) {
+            if (not contains(v)) return false;
+            bool l = v > 0 and contains(v-1);
+            bool r = v < past-1 and contains(v+1);
+            switch (kind) {
+              case array:
+                data.erase(std::lower_bound(data.begin(), data.end(), v));
+                break;
+              case bitmap:
+                bits[v >> 6] &= ~(uint64_t(1) << (v & 63));
+                break;
+              default: {
+                long k = run_before(v);
+                uint16_t s = data[2*k], e = data[2*k+1];
+                if (s == e) data.erase(data.begin() + 2*k, data.begin() + 2*k+2);
+                else if (v == s) data[2*k] = v+1;
+                else if (v == e) data[2*k+1] = v-1;
+                else {
+                    data[2*k+1] = v-1;
+                    data.insert(data.begin() + 2*k+2, {uint16_t(v+1), e});
+                }
+              }
+            }
+            --card;
+            runs = runs + (l and r) - (not l and not r);
+            adapt();
+            return true;
+        }
+
+        //! @brief Inserts all the values of another chunk.
+        void unite(roaring_chunk const& y) {
+            if (kind == array and y.kind == array and card + y.card <= array_max) {
+                std::vector<uint16_t> d;
+                d.reserve(card + y.card);
+                std::set_union(data.begin(), data.end(), y.data.begin(), y.data.end(), std::back_inserter(d));
+                data = std::move(d);
+            } else {
+                if (kind != bitmap) convert(bitmap);
+                if (y.kind == bitmap) simd::or_into(bits.data(), y.bits.data(), words);
+                else y.for_each([this](uint16_t v){
+                    bits[v >> 6] |= uint64_t(1) << (v & 63);
+                });
+            }
+            refresh();
+            optimize();
+        }
+
+        //! @brief Applies a function to every value, in increasing order.
+        template <typename F>
+        void for_each(F&& f) const {
+            switch (kind) {
+              case array:
+                for (uint16_t v : data) f(v);
+                break;
+              case bitmap:
+                for (size_t i = 0; i < words; ++i)
+                    for (uint64_t w = bits[i]; w; w &= w-1)
+                        f(uint16_t(i * 64 + __builtin_ctzll(w)));
+                break;
+              default:
+                for (size_t k = 0; k < data.size(); k += 2)
+                    for (uint32_t v = data[k]; v <= data[k+1]; ++v) f(uint16_t(v));
+            }
+        }
+
+        //! @brief Whether two chunks hold the same values.
+        bool operator==(roaring_chunk const& y) const {
+            if (key != y.key or card != y.card or runs != y.runs) return false;
+            if (kind == y.kind) return data == y.data and bits == y.bits;
+            for (uint32_t v = next(0); v < past; v = next(v+1))
+                if (not y.contains(v)) return false;
+            return true;
+        }
+
+        //! @brief Recomputes the number of elements and runs from the representation.
+        void refresh() {
+            card = runs = 0;
+            switch (kind) {
+              case array:
+                card = data.size();
+                for (size_t i = 0; i < data.size(); ++i) runs += i == 0 or data[i-1] + 1 != data[i];
+                break;
+              case bitmap: {
+                uint64_t carry = 0;
+                for (uint64_t w : bits) {
+                    card += __builtin_popcountll(w);
+                    runs += __builtin_popcountll(w & ~((w << 1) | carry));
+                    carry = w >> 63;
+                }
+                break;
+              }
+              default:
+                runs = data.size() / 2;
+                for (size_t k = 0; k < data.size(); k += 2) card += data[k+1] - data[k] + 1;
+            }
+        }
+
+        //! @brief Switches to the smallest representation.
+        void optimize() {
+            uint8_t k = best();
+            if (k != kind) convert(k);
+        }
+
+        //! @brief Serialises the content from/to a given input/output stream.
+        template <typename S>
+        S& serialize(S& s) {
+            s & key & kind;
+            if (kind == bitmap) s & bits;
+            else s & data;
+            refresh();
+            return s;
+        }
+
+        //! @brief Serialises the content from/to a given input/output stream (const overload).
+        template <typename S>
+        S& serialize(S& s) const {
+            s << key << kind;
+            return kind == bitmap ? s << bits : s << data;
+        }
+
+      private:
+        //! @brief The index of the last run starting not after a value (-1 if none).
+        long run_before(uint32_t v) const {
+            size_t lo = 0, hi = data.size() / 2;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (data[2*mid] <= v) lo = mid + 1;
+                else hi = mid;
+            }
+            return long(lo) - 1;
+        }
+
+        //! @brief The number of bytes of the values in a representation.
+        size_t bytes(uint8_t k) const {
+            if (k == array) return card <= array_max ? 2 * card : std::numeric_limits<size_t>::max();
+            if (k == bitmap) return 8 * words;
+            return 4 * runs;
+        }
+
+        //! @brief The smallest representation.
+        uint8_t best() const {
+            if (bytes(run) < bytes(array) and bytes(run) < bytes(bitmap)) return run;
+            return bytes(array) <= bytes(bitmap) ? array : bitmap;
+        }
+
+        //! @brief Switches representation when the current one became much larger than the smallest.
+        void adapt() {
+            uint8_t k = best();
+            if (k != kind and bytes(kind) > 2 * bytes(k)) convert(k);
+        }
+
+        //! @brief Switches to a given representation.
+        void convert(uint8_t k) {
+            std::vector<uint16_t> d;
+            std::vector<uint64_t> b;
+            if (k == bitmap) {
+                b.assign(words, 0);
+                for_each([&](uint16_t v){
+                    b[v >> 6] |= uint64_t(1) << (v & 63);
+                });
+            } else if (k == array) {
+                d.reserve(card);
+                for_each([&](uint16_t v){
+                    d.push_back(v);
+                });
+            } else {
+                d.reserve(2 * runs);
+                for_each([&](uint16_t v){
+                    if (not d.empty() and d.back() + 1 == v) d.back() = v;
+                    else d.insert(d.end(), {v, v});
+                });
+            }
+            data = std::move(d);
+            bits = std::move(b);
+            kind = k;
+        }
+    };
+}
+//! @endcond
+
+
+/**
+ * @brief Set of unsigned integers as a compressed bitmap, in the style of roaring bitmaps.
+ *
+ * Elements are split in chunks by their high bits, and the low 16 bits of each chunk are
+ * represented as an array, a bitmap or a list of runs, whichever is (about) the smallest.
+ * Dense or clustered sets (such as the routing sets near the root of a tree) take
+ * a fraction of the memory and serialised size of hash sets, while sparse sets take two bytes
+ * per element. Iteration is in increasing order.
+ *
+ * @param T The type of elements (an unsigned integral type).
+ */
+template <typename T>
+class roaring_set {
+    static_assert(std::is_unsigned<T>::value, "roaring sets require unsigned integral elements");
+
+    //! @brief The type of chunks.
+    using chunk_t = details::roaring_chunk<T>;
+
+  public:
+    //! @brief The type of elements.
+    using value_type = T;
+
+    //! @brief Forward iterator over the elements in increasing order.
+    class const_iterator {
+      public:
+        //! @brief Iterator traits.
+        //! @{
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T const*;
+        using reference = T;
+        //! @}
+
+        //! @brief Default constructor.
+        const_iterator() = default;
+
+        //! @brief The current element.
+        T operator*() const {
+            return T((size_t((*m_chunks)[m_i].key) << 16) | m_low);
+        }
+
+        //! @brief Moves to the next element.
+        const_iterator& operator++() {
+            m_low = (*m_chunks)[m_i].next(m_low + 1);
+            if (m_low == chunk_t::past) settle(m_i + 1);
+            return *this;
+        }
+
+        //! @brief Moves to the next element (postfix).
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+
+        //! @brief Equality operator.
+        bool operator==(const_iterator const& o) const {
+            return m_i == o.m_i and m_low == o.m_low;
+        }
+
+        //! @brief Inequality operator.
+        bool operator!=(const_iterator const& o) const {
+            return not (*this == o);
+        }
+
+      private:
+        friend class roaring_set;
+
+        //! @brief Iterator to a given low value of a given chunk.
+        const_iterator(std::vector<chunk_t> const* c, size_t i, uint32_t low) : m_chunks(c), m_i(i), m_low(low) {}
+
+        //! @brief Moves to the first element from a given chunk on (or to the end).
+        void settle(size_t i) {
+            m_i = i;
+            m_low = i < m_chunks->size() ? (*m_chunks)[i].next(0) : 0;
+        }
+
+        //! @brief The chunks of the set.
+        std::vector<chunk_t> const* m_chunks = nullptr;
+        //! @brief The index of the current chunk.
+        size_t m_i = 0;
+        //! @brief The current low value.
+        uint32_t m_low = 0;
+    };
+
+    //! @brief Iterators are read-only.
+    using iterator = const_iterator;
+
+    //! @brief Empty set.
+    roaring_set() = default;
+
+    //! @brief Set with given elements.
+    roaring_set(std::initializer_list<T> l) {
+        insert(l.begin(), l.end());
+    }
+
+    //! @brief Set with the elements of a range.
+    template <typename I>
+    roaring_set(I first, I last) {
+        insert(first, last);
+    }
+
+    //! @brief The number of elements.
+    size_t size() const {
+        return m_size;
+    }
+
+    //! @brief Whether the set has no elements.
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    //! @brief Removes all elements.
+    void clear() {
+        m_chunks.clear();
+        m_size = 0;
+    }
+
+    //! @brief Iterator to the first element.
+    const_iterator begin() const {
+        const_iterator it(&m_chunks, 0, 0);
+        it.settle(0);
+        return it;
+    }
+
+    //! @brief Iterator past the last element.
+    const_iterator end() const {
+        return const_iterator(&m_chunks, m_chunks.size(), 0);
+    }
+
+    //! @brief The number of occurrences of an element (0 or 1).
+    size_t count(T x) const {
+        size_t i = find(x >> 16);
+        return i < m_chunks.size() and m_chunks[i].key == T(x >> 16) and m_chunks[i].contains(x & 0xFFFF);
+    }
+
+    //! @brief Inserts an element, returning an iterator to it and whether it was absent.
+    std::pair<const_iterator, bool> insert(T x) {
+        size_t i = find(x >> 16);
+        if (i == m_chunks.size() or m_chunks[i].key != T(x >> 16)) {
+            m_chunks.emplace(m_chunks.begin() + i);
+            m_chunks[i].key = x >> 16;
+        }
+        bool r = m_chunks[i].insert(x & 0xFFFF);
+        m_size += r;
+        return {const_iterator(&m_chunks, i, x & 0xFFFF), r};
+    }
+
+    //! @brief Inserts the elements of a range.
+    template <typename I>
+    void insert(I first, I last) {
+        for (; first != last; ++first) insert(*first);
+    }
+
+    //! @brief Inserts all the elements of another set.
+    void insert(roaring_set const& y) {
+        std::vector<chunk_t> c;
+        c.reserve(m_chunks.size() + y.m_chunks.size());
+        size_t i = 0, j = 0;
+        while (i < m_chunks.size() or j < y.m_chunks.size()) {
+            if (j == y.m_chunks.size() or (i < m_chunks.size() and m_chunks[i].key < y.m_chunks[j].key))
+                c.push_back(std::move(m_chunks[i++]));
+            else if (i == m_chunks.size() or y.m_chunks[j].key < m_chunks[i].key)
+                c.push_back(y.m_chunks[j++]);
+            else {
+                c.push_back(std::move(m_chunks[i++]));
+                c.back().unite(y.m_chunks[j++]);
+            }
+        }
+        m_chunks = std::move(c);
+        m_size = 0;
+        for (chunk_t const& k : m_chunks) m_size += k.card;
+    }
+
+    //! @brief Removes an element, returning the number of elements removed (0 or 1).
+    size_t erase(T x) {
+        size_t i = find(x >> 16);
+        if (i == m_chunks.size() or m_chunks[i].key != T(x >> 16) or not m_chunks[i].erase(x & 0xFFFF)) return 0;
+        if (m_chunks[i].card == 0) m_chunks.erase(m_chunks.begin() + i);
+        --m_size;
+        return 1;
+    }
+
+    //! @brief Equality operator.
+    bool operator==(roaring_set const& y) const {
+        return m_chunks == y.m_chunks;
+    }
+
+    //! @brief Inequality operator.
+    bool operator!=(roaring_set const& y) const {
+        return not (*this == y);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        s & m_chunks;
+        m_size = 0;
+        for (chunk_t const& k : m_chunks) m_size += k.card;
+        return s;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << m_chunks;
+    }
+
+  private:
+    //! @brief The index of the first chunk with high bits not below a key.
+    size_t find(T key) const {
+        return std::lower_bound(m_chunks.begin(), m_chunks.end(), key, [](chunk_t const& c, T k){
+            return c.key < k;
+        }) - m_chunks.begin();
+    }
+
+    //! @brief The chunks, sorted by their high bits.
+    std::vector<chunk_t> m_chunks;
+    //! @brief The number of elements.
+    size_t m_size = 0;
+};
+
+
+//! @brief Printing roaring sets.
+template <typename T>
+std::ostream& operator<<(std::ostream& o, roaring_set<T> const& s) {
+    return o << "roaring<" << s.size() << ">";
+}
+
+
+} // fcpp
+
+#endif // FCPP_ROARING_SET_H_
@@ -0,0 +1,212 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file simd_field.hpp
+ * @brief Vectorised kernels on contiguous arrays of field values, and their gathering from fields.
+ */
+
+#ifndef FCPP_SIMD_FIELD_H_
+#define FCPP_SIMD_FIELD_H_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "lib/data.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Vectorised kernels on arrays of reals (for doubles, with a scalar fallback otherwise).
+ *
+ * The vectorised loops run on AVX2 instructions with the `FCPP_AVX2` CMake option, on SSE2 otherwise
+ * on x86-64, and the scalar loops are run on the remaining elements. All treat NaNs in the same way.
+ */
+namespace simd {
+    //! @brief Sets `dist[i] = max(nbr[i], floor)` and `sum[i] = nd[i] + dist[i]` for `n` elements.
+    template <typename R>
+    void floor_add(R const* nd, R const* nbr, R floor, R* dist, R* sum, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<R, double>::value) {
+            __m256d f = _mm256_set1_pd(floor);
+            for (; i + 4 <= n; i += 4) {
+                // the second operand is returned when one is NaN, propagating it as the scalar loop
+                __m256d d = _mm256_max_pd(f, _mm256_loadu_pd(nbr + i));
+                _mm256_storeu_pd(dist + i, d);
+                _mm256_storeu_pd(sum + i, _mm256_add_pd(_mm256_loadu_pd(nd + i), d));
+            }
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<R, double>::value) {
+            __m128d f = _mm_set1_pd(floor);
+            for (; i + 2 <= n; i += 2) {
+                __m128d d = _mm_max_pd(f, _mm_loadu_pd(nbr + i));
+                _mm_storeu_pd(dist + i, d);
+                _mm_storeu_pd(sum + i, _mm_add_pd(_mm_loadu_pd(nd + i), d));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            dist[i] = nbr[i] < floor ? floor : nbr[i];
+            sum[i] = nd[i] + dist[i];
+        }
+    }
+
+    //! @brief Sets `out[i] = (x - nd[i]) / dist[i]` for `n` elements.
+    template <typename R>
+    void slope(R x, R const* nd, R const* dist, R* out, size_t n) {
+        size_t i = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<R, double>::value) {
+            __m256d v = _mm256_set1_pd(x);
+            for (; i + 4 <= n; i += 4)
+                _mm256_storeu_pd(out + i, _mm256_div_pd(_mm256_sub_pd(v, _mm256_loadu_pd(nd + i)), _mm256_loadu_pd(dist + i)));
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<R, double>::value) {
+            __m128d v = _mm_set1_pd(x);
+            for (; i + 2 <= n; i += 2)
+                _mm_storeu_pd(out + i, _mm_div_pd(_mm_sub_pd(v, _mm_loadu_pd(nd + i)), _mm_loadu_pd(dist + i)));
+        }
+#endif
+        for (; i < n; ++i) out[i] = (x - nd[i]) / dist[i];
+    }
+
+    //! @brief The minimum of `n` elements and `init` (ignoring NaNs).
+    template <typename R>
+    R min_value(R const* x, size_t n, R init) {
+        size_t i = 0;
+        R r = init;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<R, double>::value) if (n >= 4) {
+            __m256d m = _mm256_set1_pd(init);
+            for (; i + 4 <= n; i += 4) m = _mm256_min_pd(_mm256_loadu_pd(x + i), m);
+            double v[4];
+            _mm256_storeu_pd(v, m);
+            for (double y : v) r = y < r ? y : r;
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<R, double>::value) if (n >= 2) {
+            __m128d m = _mm_set1_pd(init);
+            for (; i + 2 <= n; i += 2) m = _mm_min_pd(_mm_loadu_pd(x + i), m);
+            double v[2];
+            _mm_storeu_pd(v, m);
+            for (double y : v) r = y < r ? y : r;
+        }
+#endif
+        for (; i < n; ++i) r = x[i] < r ? x[i] : r;
+        return r;
+    }
+
+    //! @brief The maximum of `n` elements and `init`, setting `nan` if some element is NaN.
+    template <typename R>
+    R max_value(R const* x, size_t n, R init, bool& nan) {
+        size_t i = 0;
+        R r = init;
+        nan = false;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<R, double>::value) if (n >= 4) {
+            __m256d m = _mm256_set1_pd(init);
+            __m256d u = _mm256_setzero_pd();
+            for (; i + 4 <= n; i += 4) {
+                __m256d y = _mm256_loadu_pd(x + i);
+                u = _mm256_or_pd(u, _mm256_cmp_pd(y, y, _CMP_UNORD_Q));
+                m = _mm256_max_pd(y, m);
+            }
+            nan = _mm256_movemask_pd(u) != 0;
+            double v[4];
+            _mm256_storeu_pd(v, m);
+            for (double y : v) r = r < y ? y : r;
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<R, double>::value) if (n >= 2) {
+            __m128d m = _mm_set1_pd(init);
+            __m128d u = _mm_setzero_pd();
+            for (; i + 2 <= n; i += 2) {
+                __m128d y = _mm_loadu_pd(x + i);
+                u = _mm_or_pd(u, _mm_cmpunord_pd(y, y));
+                m = _mm_max_pd(y, m);
+            }
+            nan = _mm_movemask_pd(u) != 0;
+            double v[2];
+            _mm_storeu_pd(v, m);
+            for (double y : v) r = r < y ? y : r;
+        }
+#endif
+        for (; i < n; ++i) {
+            nan = nan or x[i] != x[i];
+            r = r < x[i] ? x[i] : r;
+        }
+        return r;
+    }
+}
+
+
+/**
+ * @brief Contiguous copies of the values of fields, for the neighbours of a device (excluding itself).
+ *
+ * Values are copied directly when fields are aligned to the neighbours, and looked up by device otherwise.
+ */
+class field_gather {
+  public:
+    //! @brief Sets the neighbours from the domain of a field (excluding a device).
+    template <typename A>
+    void domain(field<A> const& f, device_t self) {
+        std::vector<device_t> const& ids = fcpp::details::get_ids(f);
+        m_all = ids.size();
+        m_self = m_all;
+        m_ids.clear();
+        for (size_t i = 0; i < m_all; ++i) {
+            if (ids[i] == self) m_self = i;
+            else m_ids.push_back(ids[i]);
+        }
+        m_domain = ids;
+    }
+
+    //! @brief The number of neighbours.
+    size_t size() const {
+        return m_ids.size();
+    }
+
+    //! @brief The neighbours.
+    std::vector<device_t> const& ids() const {
+        return m_ids;
+    }
+
+    //! @brief Copies the values of a field for the neighbours, projected through a function.
+    template <typename A, typename R, typename P>
+    void copy(field<A> const& f, std::vector<R>& out, P&& proj) const {
+        out.resize(m_ids.size());
+        std::vector<device_t> const& ids = fcpp::details::get_ids(f);
+        if (ids == m_domain) {
+            // values are stored after the default, in the order of the domain
+            auto const& vals = fcpp::details::get_vals(f);
+            for (size_t i = 0, j = 0; i < m_all; ++i) if (i != m_self) out[j++] = proj(vals[i+1]);
+        } else for (size_t j = 0; j < m_ids.size(); ++j) out[j] = proj(fcpp::details::self(f, m_ids[j]));
+    }
+
+  private:
+    //! @brief The full domain (possibly including the excluded device).
+    std::vector<device_t> m_domain;
+    //! @brief The neighbours.
+    std::vector<device_t> m_ids;
+    //! @brief The size of the full domain.
+    size_t m_all = 0;
+    //! @brief The index of the excluded device in the full domain (or `m_all` if missing).
+    size_t m_self = 0;
+};
+
+
+}
+
+#endif // FCPP_SIMD_FIELD_H_
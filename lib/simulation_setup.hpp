@@ -10,6 +10,8 @@
 
 #include "lib/fcpp.hpp"
 #include "lib/generals.hpp"
+#include "lib/roaring_set.hpp"
+#include "lib/simd_bloom.hpp"
 
 #include "lib/common_setup.hpp"
 
@@ -18,6 +20,29 @@
  */
 namespace fcpp {
 
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+//! @brief The number of hash functions of Bloom filter routing sets.
+constexpr size_t bloom_hashes = 2;
+//! @brief The number of bits of Bloom filter routing sets.
+constexpr size_t bloom_bits = 256;
+//! @brief The type for a Bloom filter set of devices.
+using bloom_set_t = dynamic_bloom_filter<device_t>;
+
+#ifdef BLOOM
+//! @brief The type for a set of devices.
+using set_t = bloom_set_t;
+#elif defined(ROARING)
+//! @brief The type for a set of devices.
+using set_t = roaring_set<device_t>;
+#else
+//! @brief The type for a set of devices.
+using set_t = flat_hash_set<device_t>;
+#endif
+
+}
+
 //! @brief Namespace for component options.
 namespace option {
 
@@ -28,9 +53,11 @@ using test_aggr_t = aggregators<
     repeat_count<T<S>>,        aggregator::sum<size_t>,
     max_msg_size<T<S>>,        aggregator::max<size_t>,
     tot_msg_size<T<S>>,        aggregator::sum<size_t>,
+    max_proc_size<T<S>>,       aggregator::max<size_t>,
     tot_proc<T<S>>,            aggregator::sum<int>,
     first_delivery_tot<T<S>>,  aggregator::only_finite<aggregator::sum<times_t>>,
-    delivery_count<T<S>>,      aggregator::sum<size_t>
+    delivery_count<T<S>>,      aggregator::sum<size_t>,
+    evict_count<T<S>>,         aggregator::sum<size_t>
 >;
 
 //! @brief Storage for a given test.
@@ -40,9 +67,13 @@ using test_store_t = tuple_store<
     repeat_count<T<S>>,        size_t,
     max_msg_size<T<S>>,        size_t,
     tot_msg_size<T<S>>,        size_t,
+    max_proc_size<T<S>>,       size_t,
     tot_proc<T<S>>,            int,
     first_delivery_tot<T<S>>,  times_t,
-    delivery_count<T<S>>,      size_t
+    delivery_count<T<S>>,      size_t,
+    delivery_log<T<S>>,        delivery_ledger,
+    evict_count<T<S>>,         size_t,
+    budget_log<T<S>>,          budget_ledger
 >;
 
 //! @brief Functors for a given test.
@@ -70,35 +101,48 @@ struct noaggr {
 template <template<class> class T, typename A, template<class> class P, typename... Ts>
 using test_lines_t = plot::join<plot::value<typename A::template result_type<T<P<Ts>>>::tags::front, aggregator::only_finite<aggregator::stats<double>>>...>;
 
-//! @brief Lines for a given data and every test.
-template <template<class> class T, typename A>
-using lines_t = plot::join<
-#ifndef NOSPHERE
-    test_lines_t<T, A, spherical, legacy, share, ispp, wispp>,
-#endif
-#ifndef NOTREE
-    test_lines_t<T, A, tree,      legacy, share, ispp, wispp>,
+//! @brief Topologies whose tests are plotted together.
+template <template<class> class... Ps>
+struct topologies {
+    //! @brief Lines for a given data and every test.
+    template <template<class> class T, typename A>
+    using lines = plot::join<test_lines_t<T, A, Ps, legacy, share, ispp, wispp>..., plot::none>;
+};
+
+//! @brief Topologies whose tests are run.
+#if defined(NOSPHERE)
+using topologies_t = topologies<tree>;
+#elif defined(NOTREE)
+using topologies_t = topologies<spherical>;
+#else
+using topologies_t = topologies<spherical, tree>;
 #endif
-    plot::none
->;
+
+//! @brief Lines for a given data and every test of given topologies.
+template <template<class> class T, typename A, typename Q>
+using lines_t = typename Q::template lines<T, A>;
 
 //! @brief Time-based plot.
 template <typename S, typename... Ts>
 using single_plot_t = plot::split<S, plot::join<Ts>...>;
 
-//! @brief Overall row of plots.
-template <typename S, bool is_time = std::is_same<S,plot::time>::value, size_t t0 = is_time ? 0 : 50>
+//! @brief Overall row of plots (for given topologies).
+template <typename S, typename Q, bool is_time = std::is_same<S,plot::time>::value, size_t t0 = is_time ? 0 : 50>
 using row_plot_t = plot::join<
 #ifdef ALLPLOTS
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<max_proc, aggregator::max<int>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<max_proc, aggregator::max<int>, Q>>>,
     plot::filter<plot::time, filter::above<t0>, single_plot_t<S, plot::value<aggregator::sum<sent_count>>>>,
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<repeat_count, aggregator::sum<size_t>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<repeat_count, aggregator::sum<size_t>, Q>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<max_proc_size, aggregator::max<size_t>, Q>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, plot::value<aggregator::max<max_wire_size>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, plot::value<aggregator::sum<round_count>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<evict_count, aggregator::sum<size_t>, Q>>>,
 #endif
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<delivery_count, aggregator::sum<size_t>>>>,
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, std::conditional_t<is_time, lines_t<avg_proc, noaggr>, lines_t<avgtot_proc, noaggr>>>>,
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, std::conditional_t<is_time, lines_t<avg_size, noaggr>, lines_t<avgtot_size, noaggr>>>>,
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<max_msg_size, aggregator::max<size_t>>>>,
-    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<avg_delay, noaggr>>>
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<delivery_count, aggregator::sum<size_t>, Q>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, std::conditional_t<is_time, lines_t<avg_proc, noaggr, Q>, lines_t<avgtot_proc, noaggr, Q>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, std::conditional_t<is_time, lines_t<avg_size, noaggr, Q>, lines_t<avgtot_size, noaggr, Q>>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<max_msg_size, aggregator::max<size_t>, Q>>>,
+    plot::filter<plot::time, filter::above<t0>, single_plot_t<S, lines_t<avg_delay, noaggr, Q>>>
 >;
 
 //! @brief Applies multiple filters (empty overload).
@@ -117,25 +161,77 @@ struct multi_filter<P,T,Ts...> {
 template <typename P, typename... Ts>
 using multi_filter_t = typename multi_filter<plot::split<common::type_sequence<Ts...>, P>, Ts...>::type;
 
-//! @brief Overall plot document (one page for every variable).
-using plot_t = plot::join<
+//! @brief Overall plot document for given topologies (one page for every variable).
+template <typename Q>
+using doc_t = plot::join<
 #ifndef GRAPHICS
-    multi_filter_t<row_plot_t<tvar>,  dens, hops, speed>,
-    multi_filter_t<row_plot_t<dens>,  tvar, hops, speed>,
-    multi_filter_t<row_plot_t<hops>,  tvar, dens, speed>,
-    multi_filter_t<row_plot_t<speed>, tvar, dens, hops>,
+    multi_filter_t<row_plot_t<tvar, Q>,  dens, hops, speed>,
+    multi_filter_t<row_plot_t<dens, Q>,  tvar, hops, speed>,
+    multi_filter_t<row_plot_t<hops, Q>,  tvar, dens, speed>,
+    multi_filter_t<row_plot_t<speed, Q>, tvar, dens, hops>,
 #endif
-    multi_filter_t<row_plot_t<plot::time>, tvar, dens, hops, speed>
+    multi_filter_t<row_plot_t<plot::time, Q>, tvar, dens, hops, speed>
 >;
 
+//! @brief Plotter feeding every row to multiple plotters.
+template <typename... Ps>
+class plot_tee {
+  public:
+    //! @brief Feeds a row.
+    template <typename R>
+    plot_tee& operator<<(R const& row) {
+        std::apply([&](auto&... p){
+            [[maybe_unused]] int c[] = {0, ((p << row), 0)...};
+        }, m_plotters);
+        return *this;
+    }
+
+    //! @brief Applies a function to the index and the object of every plotter.
+    template <typename F>
+    void for_each(F&& f) {
+        size_t i = 0;
+        std::apply([&](auto&... p){
+            [[maybe_unused]] int c[] = {0, (f(i++, p), 0)...};
+        }, m_plotters);
+    }
+
+  private:
+    //! @brief The plotters.
+    std::tuple<Ps...> m_plotters;
+};
+
+#ifdef COSIM
+//! @brief Plot documents of every variant co-simulated, to be built separately.
+using plot_t = plot_tee<
+#ifndef NOSPHERE
+    doc_t<topologies<spherical>>,
+#endif
+    doc_t<topologies<tree>>,
+    doc_t<topologies<bloom>>
+>;
+
+//! @brief Names of the variants co-simulated (in the order of the plot documents).
+std::vector<std::string> const plot_names = {
+#ifndef NOSPHERE
+    "sphere",
+#endif
+    "tree",
+    "bloom"
+};
+#else
+//! @brief Overall plot document.
+using plot_t = doc_t<topologies_t>;
+#endif
+
 
 //! @brief The general simulation options.
 DECLARE_OPTIONS(list,
-    parallel<false>,     // no multithreading on node rounds
-    synchronised<false>, // optimise for asynchronous networks
+    parallel<parallel_rounds>,     // multithreading on node rounds (with the PARALLEL flag)
+    synchronised<parallel_rounds>, // rounds aligned to time slots are executed together
     program<coordination::main>,   // program to be run (refers to MAIN in process_management.hpp)
     exports<coordination::main_t>, // export type list (types used in messages)
-    retain<metric::retain<2>>, // retain time for messages
+    message_size<true>,            // computes the size of messages sent
+    retain<metric::retain<retain_time>>, // retain time for messages
     round_schedule<round_s>, // the sequence generator for round events on nodes
     log_schedule<log_s>, // the sequence generator for log events on the network
     spawn_schedule<sequence::multiple<i<devices, size_t>, n<0>>>, // the sequence generator of node creation events on the network
@@ -153,11 +249,33 @@ DECLARE_OPTIONS(list,
         right_color,                    color,
         node_size,                      double,
         node_shape,                     shape,
+        export_log,                     export_meter,
+        export_codec_log,               export_codec,
+        nbr_cache,                      frozen_neighbourhood,
+        max_wire_size,                  size_t,
+        tot_wire_size,                  size_t,
+        max_unmetered_size,             size_t,
+        tot_unmetered_size,             size_t,
+        backoff_log,                    round_backoff,
+        round_count,                    size_t,
+#ifdef BLOOM
+        below_state,                    coordination::counting_collection_state<device_t>,
+#else
+        below_state,                    coordination::delta_collection_state<coordination::set_t>,
+#endif
+#ifdef COSIM
+        bloom_state,                    coordination::counting_collection_state<device_t>,
+#endif
         hops,                           size_t
     >,
     // the basic tags and corresponding aggregators to be logged
     aggregators<
-        sent_count,         aggregator::sum<size_t>
+        max_wire_size,      aggregator::max<size_t>,
+        tot_wire_size,      aggregator::sum<size_t>,
+        max_unmetered_size, aggregator::max<size_t>,
+        tot_unmetered_size, aggregator::sum<size_t>,
+        sent_count,         aggregator::sum<size_t>,
+        round_count,        aggregator::sum<size_t>
     >,
     // further options for each test
 #ifndef NOSPHERE
@@ -165,6 +283,9 @@ DECLARE_OPTIONS(list,
 #endif
 #ifndef NOTREE
     test_option_t<tree,      legacy, share, ispp, wispp>,
+#endif
+#ifdef COSIM
+    test_option_t<bloom,     legacy, share, ispp, wispp>,
 #endif
     // data initialisation
     init<
@@ -0,0 +1,185 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file size_stream.hpp
+ * @brief Output archive computing the serialised size of objects, without producing their bytes.
+ */
+
+#ifndef FCPP_SIZE_STREAM_H_
+#define FCPP_SIZE_STREAM_H_
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Bytes used by output streams to encode the length of a container.
+constexpr size_t size_prefix = sizeof(size_t);
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Serialised size of a type if fixed, zero otherwise (general form).
+    template <typename T, typename = void>
+    struct fixed_size : std::integral_constant<size_t, 0> {};
+
+    //! @brief Serialised size of arithmetic and enumeration types.
+    template <typename T>
+    struct fixed_size<T, std::enable_if_t<std::is_arithmetic<T>::value or std::is_enum<T>::value>> : std::integral_constant<size_t, sizeof(T)> {};
+
+    //! @brief Sum of fixed sizes of some types, zero if any is not fixed.
+    template <typename... Ts>
+    struct fixed_size_sum : std::integral_constant<size_t, 0> {};
+
+    //! @brief Sum of fixed sizes of some types, zero if any is not fixed (non-empty overload).
+    template <typename T, typename... Ts>
+    struct fixed_size_sum<T, Ts...> : std::integral_constant<size_t,
+        fixed_size<T>::value == 0 or (sizeof...(Ts) > 0 and fixed_size_sum<Ts...>::value == 0) ? 0 : fixed_size<T>::value + fixed_size_sum<Ts...>::value
+    > {};
+
+    //! @brief Serialised size of pairs.
+    template <typename T, typename U>
+    struct fixed_size<std::pair<T, U>> : fixed_size_sum<std::remove_const_t<T>, U> {};
+
+    //! @brief Serialised size of tuples.
+    template <typename... Ts>
+    struct fixed_size<std::tuple<Ts...>> : fixed_size_sum<Ts...> {};
+
+    //! @brief Serialised size of arrays.
+    template <typename T, size_t N>
+    struct fixed_size<std::array<T, N>> : std::integral_constant<size_t, N * fixed_size<T>::value> {};
+
+    //! @brief Whether a type declares to serialise as the sequence of its elements.
+    template <typename T, typename = void>
+    struct sequence_marker : std::false_type {};
+
+    //! @brief Whether a type declares to serialise as the sequence of its elements.
+    template <typename T>
+    struct sequence_marker<T, std::void_t<typename T::sequence_serialization>> : std::true_type {};
+
+    //! @brief Whether a container serialises as the sequence of its elements (without a `serialize` member).
+    template <typename T, typename S, typename = void>
+    struct sequence_serialized : std::true_type {};
+
+    //! @brief Whether a container serialises as the sequence of its elements (with a `serialize` member).
+    template <typename T, typename S>
+    struct sequence_serialized<T, S, std::void_t<decltype(std::declval<T const&>().serialize(std::declval<S&>()))>> : sequence_marker<T> {};
+
+    //! @brief Priority ranks for overload resolution.
+    template <size_t n>
+    struct rank : rank<n-1> {};
+
+    //! @brief Priority ranks for overload resolution (lowest).
+    template <>
+    struct rank<0> {};
+}
+//! @endcond
+
+
+/**
+ * @brief Serialised size of values of a type, if it does not depend on the value (zero otherwise).
+ *
+ * The size is available at compile time for arithmetic types, enumerations, and arrays, pairs
+ * and tuples thereof.
+ */
+template <typename T>
+constexpr size_t fixed_size = details::fixed_size<std::decay_t<T>>::value;
+
+
+/**
+ * @brief Output archive counting the bytes that would be written by an output stream.
+ *
+ * It supports the `serialize` members of user types through the `<<` and `&` operators, and
+ * computes the size of containers of fixed-size elements in constant time (for containers with
+ * a `serialize` member, only if they declare a `sequence_serialization` type).
+ */
+class size_stream {
+  public:
+    //! @brief The number of bytes counted so far.
+    size_t size() const {
+        return m_size;
+    }
+
+    //! @brief Counts the bytes of a value.
+    template <typename T>
+    size_stream& operator<<(T const& x) {
+        count(x, details::rank<3>{});
+        return *this;
+    }
+
+    //! @brief Counts the bytes of a value (for `serialize` members).
+    template <typename T>
+    size_stream& operator&(T const& x) {
+        return *this << x;
+    }
+
+  private:
+    //! @brief Values of fixed size.
+    template <typename T>
+    std::enable_if_t<(fixed_size<T> > 0)> count(T const&, details::rank<3>) {
+        m_size += fixed_size<T>;
+    }
+
+    //! @brief Containers of elements of fixed size, serialised as the sequence of their elements.
+    template <typename T, typename V = typename T::value_type>
+    auto count(T const& x, details::rank<2>) -> std::enable_if_t<(fixed_size<V> > 0 and details::sequence_serialized<T, size_stream>::value), decltype(std::begin(x), x.size(), void())> {
+        m_size += size_prefix + x.size() * fixed_size<V>;
+    }
+
+    //! @brief Objects with a `serialize` member.
+    template <typename T>
+    auto count(T const& x, details::rank<1>) -> decltype(x.serialize(*this), void()) {
+        x.serialize(*this);
+    }
+
+    //! @brief Containers of elements of variable size.
+    template <typename T>
+    auto count(T const& x, details::rank<0>) -> decltype(std::begin(x), std::end(x), void()) {
+        m_size += size_prefix;
+        for (auto const& y : x) *this << y;
+    }
+
+    //! @brief Pairs of variable size.
+    template <typename T, typename U>
+    void count(std::pair<T, U> const& x, details::rank<0>) {
+        *this << x.first << x.second;
+    }
+
+    //! @brief Tuples of variable size.
+    template <typename... Ts>
+    void count(std::tuple<Ts...> const& x, details::rank<0>) {
+        count_tuple(x, std::index_sequence_for<Ts...>{});
+    }
+
+    //! @brief Counts the elements of a tuple.
+    template <typename T, size_t... is>
+    void count_tuple(T const& x, std::index_sequence<is...>) {
+        [[maybe_unused]] int c[] = {0, ((*this << std::get<is>(x)), 0)...};
+    }
+
+    //! @brief The number of bytes counted so far.
+    size_t m_size = 0;
+};
+
+
+//! @brief The number of bytes of the serialisation of a value.
+template <typename T>
+size_t serialized_size(T const& x) {
+    size_stream s;
+    s << x;
+    return s.size();
+}
+
+
+} // fcpp
+
+#endif // FCPP_SIZE_STREAM_H_
@@ -0,0 +1,196 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file sweep_manifest.hpp
+ * @brief Manifest of the completed runs of a batch sweep, allowing interrupted or extended sweeps to be resumed.
+ */
+
+#ifndef FCPP_SWEEP_MANIFEST_H_
+#define FCPP_SWEEP_MANIFEST_H_
+
+#include <algorithm>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lib/fcpp.hpp"
+#include "lib/parallel_batch.hpp"
+#include "lib/result_writer.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief Joins parameter values into a manifest key (with full precision).
+template <typename... Ts>
+std::string manifest_key(Ts const&... xs) {
+    std::stringstream ss;
+    ss.precision(std::numeric_limits<double>::max_digits10);
+    [[maybe_unused]] int c[] = {0, (ss << xs << ' ', 0)...};
+    std::string s = ss.str();
+    if (not s.empty()) s.pop_back();
+    return s;
+}
+
+
+//! @brief The path of the result file of a shard of a sweep (with the index of the shard before the extension).
+inline std::string shard_path(std::string const& path, size_t shard) {
+    size_t dot = path.find_last_of('.');
+    size_t slash = path.find_last_of('/');
+    if (dot == std::string::npos or (slash != std::string::npos and dot < slash)) return path + "." + std::to_string(shard);
+    return path.substr(0, dot) + "." + std::to_string(shard) + path.substr(dot);
+}
+
+
+/**
+ * @brief Manifest of completed runs, mapping their keys to the offsets of their groups in a result file.
+ *
+ * The manifest is a text file with a line `offset key` for every run, appended (and flushed) as
+ * soon as the group of the run has been written. Lookups only consider the runs completed
+ * before the construction of the manifest, so that they can be performed concurrently with records.
+ */
+class sweep_manifest {
+  public:
+    //! @brief Constructor given a path, whether to keep the runs already recorded in it, and whether to record new runs.
+    sweep_manifest(std::string const& path, bool resume, bool record = true) {
+        if (resume) {
+            std::ifstream in(path);
+            uint64_t offset;
+            std::string key;
+            while (in >> offset and in.get() == ' ' and std::getline(in, key))
+                m_done[key] = offset;
+        }
+        if (record) m_out.open(path, resume ? std::ios::app : std::ios::trunc);
+    }
+
+    //! @brief Looks up the offset of the group of a completed run, returning whether it was found.
+    bool find(std::string const& key, uint64_t& offset) const {
+        auto it = m_done.find(key);
+        if (it == m_done.end()) return false;
+        offset = it->second;
+        return true;
+    }
+
+    //! @brief Records the offset of the group of a completed run.
+    void record(std::string const& key, uint64_t offset) {
+        m_out << offset << ' ' << key << '\n' << std::flush;
+    }
+
+    //! @brief The number of runs completed before construction.
+    size_t size() const {
+        return m_done.size();
+    }
+
+  private:
+    //! @brief The runs completed before construction.
+    std::unordered_map<std::string, uint64_t> m_done;
+    //! @brief The manifest file.
+    std::ofstream m_out;
+};
+
+
+/**
+ * @brief Runs a sequence of simulations on a pool of threads, skipping the runs already completed by previous sweeps.
+ *
+ * Behaves as `parallel_run` on a `streaming_plotter` writing to `results`, recording every run
+ * completed in a manifest `results.manifest`, keyed by `key(sequence[i])`. If the binary result
+ * file already exists with the same columns, the runs whose key is in the manifest are not
+ * simulated: their rows are replayed from the file instead, which is extended with the new runs only.
+ * Runs recorded in the further `sources` result files (e.g. the shards of a sweep) are not simulated
+ * either: their rows are copied into `results`.
+ * The columns are learnt through a probe run of `sequence[0]` with end of simulated time (tag `E`) set to zero.
+ * Otherwise (or for CSV files), the sweep starts from scratch.
+ *
+ * @param E The tag of the end of simulated time in the sequence.
+ * @param T The component type, whose plotter must be a `plot_shard<streaming_plotter<P>>`.
+ * @param plotter The plotter to be fed with the rows of every run.
+ * @param sequence The tagged tuple sequence of initialisation values.
+ * @param key Function computing the key of a tuple of initialisation values.
+ * @param results The path of the result file.
+ * @param threads The number of worker threads (defaults to the available cores).
+ * @param sources Further result files (with manifests) whose runs are copied rather than simulated.
+ */
+template <typename E, typename T, typename P, typename S, typename K>
+void resumable_run(T, P& plotter, S const& sequence, K&& key, std::string const& results, size_t threads = std::thread::hardware_concurrency(), std::vector<std::string> const& sources = {}) {
+    using stream_t = streaming_plotter<P>;
+    using net_t = typename T::net;
+    auto usable = [](std::string const& r){
+        return result_writer::format_of(r) == result_format::binary and std::filesystem::exists(r) and std::filesystem::exists(r + ".manifest");
+    };
+    plot_shard<stream_t> probe;
+    if (sequence.size() > 0 and (usable(results) or std::any_of(sources.begin(), sources.end(), usable))) {
+        auto init_v = sequence[0];
+        common::get<E>(init_v) = 0;
+        common::get<component::tags::plotter>(init_v) = &probe;
+        net_t network{init_v};
+        network.run();
+    }
+    auto compatible = [&](std::string const& r){
+        return probe.replayer() and usable(r) and result_reader(r).columns() == probe.columns();
+    };
+    bool resume = compatible(results);
+    result_writer writer(results, resume);
+    sweep_manifest manifest(results + ".manifest", resume);
+    // result files whose runs can be replayed: the resumed one first (mapped after the writer has dropped its footer)
+    struct source_t {
+        std::unique_ptr<result_reader> reader;
+        sweep_manifest const* manifest;
+        bool copy;
+    };
+    std::vector<source_t> cache;
+    std::deque<sweep_manifest> loaded;
+    if (resume) cache.push_back({std::make_unique<result_reader>(results), &manifest, false});
+    for (std::string const& r : sources) {
+        if (r == results) continue;
+        if (not compatible(r)) {
+            std::cerr << "ignoring missing or incompatible result file " << r << std::endl;
+            continue;
+        }
+        loaded.emplace_back(r + ".manifest", true, false);
+        cache.push_back({std::make_unique<result_reader>(r), &loaded.back(), true});
+    }
+    stream_t stream(plotter, writer);
+    stream.listen([&](size_t i, uint64_t offset){
+        manifest.record(key(sequence[i]), offset);
+    });
+    auto const& replay = probe.replayer();
+    std::function<bool(size_t, plot_shard<stream_t>&)> cached = [&](size_t i, plot_shard<stream_t>& shard){
+        std::string k = key(sequence[i]);
+        for (source_t const& src : cache) {
+            uint64_t offset;
+            if (not src.manifest->find(k, offset)) continue;
+            result_reader::group const* g = src.reader->find(offset);
+            if (g == nullptr) continue;
+            bool copy = src.copy;
+            shard.append([&replay,g,copy](stream_t& s){
+                s.mute(not copy);
+                replay(s, *g);
+                s.mute(false);
+            });
+            return true;
+        }
+        return false;
+    };
+    parallel_run(T{}, stream, sequence, threads, cached);
+    writer.close();
+}
+
+} // batch
+
+} // fcpp
+
+#endif // FCPP_SWEEP_MANIFEST_H_
@@ -22,49 +22,70 @@ namespace fcpp {
 namespace coordination {
 
 //! @brief Generating distribution for distance estimations.
-std::weibull_distribution<real_t> dist_distr = distribution::make<std::weibull_distribution>(real_t(1), real_t(dist_dev*0.01));
+std::weibull_distribution<real_t> const dist_distr = distribution::make<std::weibull_distribution>(real_t(1), real_t(dist_dev*0.01));
 
 
 //! @brief Adjusted nbr_dist value accounting for errors.
-FUN field<real_t> adjusted_nbr_dist(ARGS) {
-    return node.nbr_dist() * rand_hood(CALL, dist_distr) + node.storage(tags::speed{}) * comm / period * node.nbr_lag();
+FUN field<real_t> adjusted_nbr_dist(ARGS) { PROFILE_CODE
+    return cached_nbr_dist(CALL) * fast_rand_hood(CALL, dist_distr) + node.storage(tags::speed{}) * comm / period * node.nbr_lag();
 }
 
-//! @brief Message bytes overhead per process due to the termination strategy.
-template <typename T>
-class termination_overhead;
+/**
+ * @brief Records in the export meter the bytes of values exported on behalf of a process (one entry per value).
+ *
+ * With delta encoded exports, only the values changed since the version acknowledged by neighbours
+ * are counted, together with a mask signalling which values of the group are sent. Values are
+ * identified by the call point, the process and their position in the group.
+ */
+template <typename node_t, typename... Ts>
+void meter_export(ARGS, message const& m, Ts const&... xs) {
+    if (delta_exports) {
+        export_codec& c = node.storage(tags::export_codec_log{});
+        uint64_t k = export_codec::key(node.stack_trace.hash(call_point), m.hash());
+        size_t b = export_codec::mask_bytes;
+        ((b += c.encode(k++, xs)), ...);
+        node.storage(tags::export_log{}).record(m, b, (export_bytes(xs) + ... + 0));
+    } else node.storage(tags::export_log{}).record(m, (export_bytes(xs) + ... + 0));
+}
+
+//! @brief Bytes exported for a value outside of processes (only if changed since acknowledged, with delta encoded exports).
+GEN(T) size_t sent_bytes(ARGS, T const& x) {
+    node.storage(tags::export_log{}).wire(export_bytes(x));
+    if (not delta_exports) return export_bytes(x);
+    export_codec& c = node.storage(tags::export_codec_log{});
+    return c.encode(export_codec::key(node.stack_trace.hash(call_point), 0), x) + export_codec::mask_bytes;
+}
 
 //! @brief Legacy termination logic (COORD19).
 template <typename node_t, template<class> class T>
-void termination_logic(ARGS, status& s, real_t, message const&, T<tags::legacy>) {
+void termination_logic(ARGS, status& s, real_t, message const& m, T<tags::legacy>) { PROFILE_CODE
      bool terminating = s == status::terminated_output;
      bool terminated = old(CALL, terminating, [&](bool ot){
+        meter_export(CALL, m, ot);
         return any_hood(CALL, nbr(CALL, ot), ot) or terminating;
      });
+    meter_export(CALL, m, terminated);
     bool exiting = all_hood(CALL, nbr(CALL, terminated), terminated);
     if (exiting) s = status::external_deprecated;
     else if (terminating) s = status::internal_output;
 }
-//! @brief Overhead of the legacy termination logic.
-template<template<class> class T> class termination_overhead<T<tags::legacy>> : public std::integral_constant<size_t, 2*sizeof(bool) + 2*sizeof(trace_t)> {};
 
 //! @brief Legacy termination logic updated to use share (LMCS2020) instead of rep+nbr.
 template <typename node_t, template<class> class T>
-void termination_logic(ARGS, status& s, real_t, message const&, T<tags::share>) {
+void termination_logic(ARGS, status& s, real_t, message const& m, T<tags::share>) { PROFILE_CODE
     bool terminating = s == status::terminated_output;
     bool terminated = nbr(CALL, terminating, [&](field<bool> nt){
         return any_hood(CALL, nt) or terminating;
     });
+    meter_export(CALL, m, terminated, terminated);
     bool exiting = all_hood(CALL, nbr(CALL, terminated), terminated);
     if (exiting) s = status::external_deprecated;
     else if (terminating) s = status::internal_output;
 }
-//! @brief Overhead of the share termination logic.
-template<template<class> class T> class termination_overhead<T<tags::share>> : public std::integral_constant<size_t, 2*sizeof(bool) + 2*sizeof(trace_t)> {};
 
 //! @brief Novel termination logic.
 template <typename node_t, template<class> class T>
-void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::ispp>) {
+void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::ispp>) { PROFILE_CODE
     using namespace tags;
 
     bool terminating = s == status::terminated_output;
@@ -72,8 +93,10 @@ void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::ispp
         return any_hood(CALL, nt) or terminating;
     });
     bool source = m.from == node.uid;
-    double ds = monotonic_distance(CALL, source, adjusted_nbr_dist(CALL));
-    double dt = monotonic_distance(CALL, source, node.nbr_lag());
+    tuple<real_t, real_t> d = monotonic_distances(CALL, source, adjusted_nbr_dist(CALL), node.nbr_lag());
+    meter_export(CALL, m, terminated, d);
+    double ds = get<0>(d);
+    double dt = get<1>(d);
     bool slow = ds < v * comm / period * (dt - period);
     if (terminated or slow) {
         if (s == status::terminated_output) s = status::border_output;
@@ -81,19 +104,19 @@ void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::ispp
         if (s == status::internal_output) s = status::border_output;
     }
 }
-//! @brief Overhead of the novel termination logic.
-template<template<class> class T> class termination_overhead<T<tags::ispp>> : public std::integral_constant<size_t, sizeof(bool) + 2*sizeof(real_t) + 3*sizeof(trace_t)> {};
 
 //! @brief Wave-like termination logic.
 template <typename node_t, template<class> class T>
-void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::wispp>) {
+void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::wispp>) { PROFILE_CODE
     bool terminating = s == status::terminated_output;
     bool terminated = nbr(CALL, terminating, [&](field<bool> nt){
         return any_hood(CALL, nt) or terminating;
     });
     bool source = m.from == node.uid and old(CALL, true, false);
-    double ds = monotonic_distance(CALL, source, adjusted_nbr_dist(CALL));
-    double dt = monotonic_distance(CALL, source, node.nbr_lag());
+    tuple<real_t, real_t> d = monotonic_distances(CALL, source, adjusted_nbr_dist(CALL), node.nbr_lag());
+    meter_export(CALL, m, terminated, d);
+    double ds = get<0>(d);
+    double dt = get<1>(d);
     bool slow = ds < v * comm / period * (dt - period);
     if (terminated or slow) {
         if (s == status::terminated_output) s = status::border_output;
@@ -101,11 +124,9 @@ void termination_logic(ARGS, status& s, real_t v, message const& m, T<tags::wisp
         if (s == status::internal_output) s = status::border_output;
     }
 }
-//! @brief Overhead of the wave-like termination logic.
-template<template<class> class T> class termination_overhead<T<tags::wispp>> : public std::integral_constant<size_t, sizeof(bool) + 2*sizeof(real_t) + 3*sizeof(trace_t)> {};
 
 //! @brief Export list for termination_logic.
-FUN_EXPORT termination_logic_t = export_list<bool, monotonic_distance_t>;
+FUN_EXPORT termination_logic_t = export_list<bool, monotonic_distances_t>;
 
 //! @brief Result type of spawn calls with messages as keys.
 using message_log_type = std::unordered_map<message, times_t, common::hash<message>>;
@@ -115,16 +136,20 @@ using key_log_type = std::unordered_map<device_t, message, common::hash<device_t
 
 
 //! @brief Computes stats on message delivery and active processes.
-GEN(T) void proc_stats(ARGS, message_log_type const& nm, int render, T, size_t base_overhead, size_t variable_overhead) {
+GEN(T) void proc_stats(ARGS, message_log_type const& nm, int render, T, size_t base_overhead) { PROFILE_CODE
     // import tags for convenience
     using namespace tags;
     // stats on number of active processes
     int proc_num = node.storage(proc_data{}).size() - 1;
     node.storage(max_proc<T>{}) = max(node.storage(max_proc<T>{}), proc_num);
     node.storage(tot_proc<T>{}) += proc_num;
-    size_t ms = proc_num * (sizeof(message) + sizeof(status) + termination_overhead<T>::value + variable_overhead) + base_overhead;
+    // stats on exported bytes, as recorded by the processes since the last call point (and by the codec protocol)
+    export_meter::call_point_data bytes = node.storage(export_log{}).close(node.stack_trace.hash(call_point));
+    size_t ms = bytes.bytes + base_overhead;
+    if (delta_exports) ms += node.storage(export_codec_log{}).versions_bytes();
     node.storage(max_msg_size<T>{}) = max(node.storage(max_msg_size<T>{}), ms);
     node.storage(tot_msg_size<T>{}) += ms;
+    node.storage(max_proc_size<T>{}) = max(node.storage(max_proc_size<T>{}), bytes.max_process);
     // additional node rendering
     if (render >= 0) {
         if (proc_num > 0) node.storage(node_size{}) *= 1.2;
@@ -132,40 +157,80 @@ GEN(T) void proc_stats(ARGS, message_log_type const& nm, int render, T, size_t b
         if (render == 1) node.storage(left_color{})  = node.storage(proc_data{}).back();
         if (render == 2) node.storage(right_color{}) = node.storage(proc_data{}).back();
     }
-    // stats on delivery success
-    old(node, call_point, message_log_type{}, [&](message_log_type m){
-        for (auto const& x : nm) {
-            if (m.count(x.first)) {
-                node.storage(repeat_count<T>{}) += 1;
-            } else {
-                node.storage(first_delivery_tot<T>{}) += x.second - x.first.time;
-                node.storage(delivery_count<T>{}) += 1;
-                m[x.first] = x.second;
-            }
+    // stats on delivery success (the ledger in storage is updated in place)
+    delivery_ledger& ledger = node.storage(delivery_log<T>{});
+    ledger.expire(node.current_time() - delivery_ttl);
+    for (auto const& x : nm) {
+        if (ledger.insert(x.first, x.second)) {
+            node.storage(first_delivery_tot<T>{}) += x.second - x.first.time;
+            node.storage(delivery_count<T>{}) += 1;
+        } else {
+            node.storage(repeat_count<T>{}) += 1;
         }
-        return m;
+    }
+}
+
+//! @brief Starts the export codec for the current round, exchanging the versions of exports with neighbours.
+FUN void codec_round(ARGS) { CODE PROFILE_CODE
+    export_codec& c = node.storage(tags::export_codec_log{});
+    nbr(CALL, export_versions{}, [&](field<export_versions> x){
+        for (device_t id : fcpp::details::get_ids(x)) if (id != node.uid) c.receive(id, fcpp::details::self(x, id), node.uid);
+        return c.round(keyframe_period);
     });
+    node.storage(tags::export_log{}).wire(c.versions_bytes());
 }
-//! @brief Export list for proc_stats.
-FUN_EXPORT proc_stats_t = export_list<message_log_type>;
+//! @brief Export list for codec_round.
+FUN_EXPORT codec_round_t = export_list<export_versions>;
 
-//! @brief Wrapper calling a spawn function with a given process and key set, while tracking the processes executed.
-GEN(T,G,S) message_log_type spawn_profiler(ARGS, T, G&& process, S&& key_set, real_t v, int render, size_t base_overhead, size_t variable_overhead) {
+/**
+ * @brief Computes stats on the messages actually sent, and starts the export meter (and codec) for the current round.
+ *
+ * The size of the message sent in the last round is checked against the full size of the values
+ * metered in it, so that values exported without being metered show up as unmetered bytes.
+ */
+FUN void wire_stats(ARGS) { CODE PROFILE_CODE
+    // import tags for convenience
+    using namespace tags;
+    size_t ws = node.msg_size();
+    node.storage(max_wire_size{}) = max(node.storage(max_wire_size{}), ws);
+    node.storage(tot_wire_size{}) += ws;
+    export_meter& e = node.storage(export_log{});
+    size_t us = ws > e.wire_bytes() ? ws - e.wire_bytes() : e.wire_bytes() - ws;
+    node.storage(max_unmetered_size{}) = max(node.storage(max_unmetered_size{}), us);
+    node.storage(tot_unmetered_size{}) += us;
+    e.clear();
+    if (delta_exports) codec_round(CALL);
+}
+//! @brief Export list for wire_stats.
+FUN_EXPORT wire_stats_t = export_list<codec_round_t>;
+
+/**
+ * @brief Wrapper calling a spawn function with a given process and key set, while tracking the processes executed.
+ *
+ * Under a bounded budget, processes not admitted by the node plan are not run (and left as external).
+ */
+GEN(T,G,S) message_log_type spawn_profiler(ARGS, T, G&& process, S&& key_set, real_t v, int render, size_t base_overhead, process_budget const& budget = {}) { PROFILE_CODE
+    budget_ledger& ledger = node.storage(tags::budget_log<T>{});
     // dispatches messages
     message_log_type r = spawn_deprecated(node, call_point, [&](message const& m){
+        if (budget.bounded() and not ledger.admit(m, node.current_time(), budget))
+            return decltype(process(m)){node.current_time(), status::external_deprecated};
         auto r = process(m);
         termination_logic(CALL, get<1>(r), v, m, T{});
+        meter_export(CALL, m, make_tuple(m, get<1>(r)));
         real_t key = get<1>(r) == status::external_deprecated ? 0.5 : 1;
         node.storage(tags::proc_data{}).push_back(color::hsva(m.data * 360, key, key));
         return r;
     }, std::forward<S>(key_set));
+    // plans the processes of the next round, given the bytes they exported
+    if (budget.bounded()) node.storage(tags::evict_count<T>{}) += ledger.plan(node.storage(tags::export_log{}).processes(), budget);
     // compute stats
-    proc_stats(CALL, r, render, T{}, base_overhead, variable_overhead);
+    proc_stats(CALL, r, render, T{}, base_overhead);
 
     return r;
 }
 //! @brief Export list for spawn_profiler.
-FUN_EXPORT spawn_profiler_t = export_list<spawn_t<message, status>, termination_logic_t, proc_stats_t>;
+FUN_EXPORT spawn_profiler_t = export_list<spawn_t<message, status>, termination_logic_t>;
 
 } // coordination
 
@@ -4,17 +4,72 @@ git submodule init
 git submodule update
 mkdir -p plot
 cp fcpp/src/extras/plotter/plot.asy plot/
+# restores the results of a previous sweep of a scenario, to be resumed
+resume() {
+    if [ -f "plot/$1 batch.fcol.manifest" ]; then
+        mv "plot/$1 batch.fcol" plot/batch.fcol
+        mv "plot/$1 batch.fcol.manifest" plot/batch.fcol.manifest
+    fi
+}
 if [ "$1" == "plots" ]; then
+    resume "sphere"
     fcpp/src/make.sh run -O -DNOTREE batch
     cat plot/batch.asy | sed 's|plot.ROWS = 1|plot.ROWS = 5|g' > "plot/sphere batch.asy"
-    fcpp/src/make.sh run -O -DNOSPHERE batch
-    cat plot/batch.asy | sed 's|plot.ROWS = 1|plot.ROWS = 5|g' > "plot/tree batch.asy"
-    fcpp/src/make.sh run -O -DNOSPHERE -DBLOOM batch
-    cat plot/batch.asy | sed 's|plot.ROWS = 1|plot.ROWS = 5|g' > "plot/bloom batch.asy"
-    rm plot/batch.{asy,pdf}
+    mv plot/batch.fcol "plot/sphere batch.fcol"
+    mv plot/batch.fcol.manifest "plot/sphere batch.fcol.manifest"
+    # exact and Bloom filter trees co-simulated on the same mobility and connectivity
+    resume "cosim"
+    fcpp/src/make.sh run -O -DNOSPHERE -DCOSIM batch
+    sed -i 's|plot.ROWS = 1|plot.ROWS = 5|g' "plot/tree batch.asy" "plot/bloom batch.asy"
+    mv plot/batch.fcol "plot/cosim batch.fcol"
+    mv plot/batch.fcol.manifest "plot/cosim batch.fcol.manifest"
+    rm -f plot/batch.{asy,pdf}
     cd plot
     asy -mask {sphere,tree,bloom}" batch.asy" -f pdf
     cd ..
+elif [ "$1" == "delta" ]; then
+    # same sweeps as plots with delta encoded exports, for comparing sizes against the full ones
+    resume "sphere delta"
+    fcpp/src/make.sh run -O -DNOTREE -DDELTA batch
+    cat plot/batch.asy | sed 's|plot.ROWS = 1|plot.ROWS = 5|g' > "plot/sphere delta batch.asy"
+    mv plot/batch.fcol "plot/sphere delta batch.fcol"
+    mv plot/batch.fcol.manifest "plot/sphere delta batch.fcol.manifest"
+    resume "cosim delta"
+    # the co-simulation writes its plot files under fixed names: the ones of the full sweep are set aside
+    for t in tree bloom; do
+        if [ -f "plot/$t batch.asy" ]; then mv "plot/$t batch.asy" "plot/$t batch.asy.full"; fi
+    done
+    fcpp/src/make.sh run -O -DNOSPHERE -DCOSIM -DDELTA batch
+    for t in tree bloom; do
+        sed 's|plot.ROWS = 1|plot.ROWS = 5|g' "plot/$t batch.asy" > "plot/$t delta batch.asy"
+        rm -f "plot/$t batch.asy"
+        if [ -f "plot/$t batch.asy.full" ]; then mv "plot/$t batch.asy.full" "plot/$t batch.asy"; fi
+    done
+    mv plot/batch.fcol "plot/cosim delta batch.fcol"
+    mv plot/batch.fcol.manifest "plot/cosim delta batch.fcol.manifest"
+    rm -f plot/batch.{asy,pdf}
+    cd plot
+    asy -mask {sphere,tree,bloom}" delta batch.asy" -f pdf
+    cd ..
+elif [ "$1" == "regression" ]; then
+    status=0
+    fcpp/src/make.sh run -O -DNOTREE regression || status=1
+    fcpp/src/make.sh run -O -DNOSPHERE regression || status=1
+    fcpp/src/make.sh run -O -DNOSPHERE -DBLOOM regression || status=1
+    fcpp/src/make.sh run -O -DNOSPHERE -DCOSIM regression || status=1
+    fcpp/src/make.sh run -O -DCASE_STUDY regression || status=1
+    exit $status
+elif [ "$1" == "adaptive" ]; then
+    fcpp/src/make.sh run -O -DADAPTIVE -DNOTREE adaptive_check
+elif [ "$1" == "speedup" ]; then
+    # the same slotted schedule, executed serially and in parallel
+    shift
+    serial=$(fcpp/src/make.sh run -O -DSLOTS speedup "$@" | grep '^{"devices"')
+    parallel=$(fcpp/src/make.sh run -O -DPARALLEL speedup "$@" | grep '^{"devices"')
+    echo "$serial"
+    echo "$parallel"
+    wall() { echo "$1" | sed 's|.*"wall_s": \([0-9.e+-]*\).*|\1|'; }
+    echo "speedup: $(awk "BEGIN { print $(wall "$serial") / $(wall "$parallel") }")"
 elif [ "$1" == "window" ]; then
     fcpp/src/make.sh gui run -O -DNOTREE -DGRAPHICS graphic
     cat plot/graphic.asy | sed 's|plot.ROWS = 1|plot.ROWS = 5|g' > "plot/sphere graphic.asy"
@@ -30,7 +85,11 @@ else
     if [ "$1" == "" ]; then
         echo -e "\033[4msimplified usage:\033[0m"
         echo -e "    \033[1m./make.sh plots\033[0m                  produces plots through non-interactive batch runs"
+        echo -e "    \033[1m./make.sh delta\033[0m                  produces plots as above, with delta encoded exports"
         echo -e "    \033[1m./make.sh window\033[0m                 opens interactive windows for a spherical and tree scenario"
+        echo -e "    \033[1m./make.sh regression\033[0m             compares the throughput of fixed scenarios against a baseline"
+        echo -e "    \033[1m./make.sh adaptive\033[0m               checks that idle devices run fewer rounds without losing neighbours"
+        echo -e "    \033[1m./make.sh speedup\033[0m                measures the speedup of parallel rounds on a single large simulation"
         echo
         echo -e "the number of batch runs can be tweaked through constant \033[1mruns\033[0m in \033[1mbatch.cpp\033[0m"
         echo
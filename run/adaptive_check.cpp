@@ -0,0 +1,76 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file adaptive_check.cpp
+ * @brief Checks that idle devices run fewer rounds with the ADAPTIVE flag, without losing neighbours.
+ *
+ * Runs a fixed seeded spherical scenario headless on a static topology, where any neighbour lost
+ * across rounds is due to a device being silent for longer than the retain time. Exits with a
+ * failure if no planned round is skipped, or if some neighbour is lost.
+ * Meant to be compiled with the `ADAPTIVE` and `NOTREE` flags.
+ */
+
+#include <iostream>
+#include <vector>
+
+#include "lib/process_management.hpp"
+#include "lib/simulation_setup.hpp"
+
+using namespace fcpp;
+
+static_assert(adaptive_rounds, "the check requires the ADAPTIVE flag");
+
+//! @brief The end of simulated time.
+constexpr int end = 100;
+
+//! @brief The backoff state of every device after its last round.
+std::vector<round_backoff> backoffs;
+
+//! @brief The number of rounds executed.
+size_t rounds = 0;
+
+//! @brief Program running another one, while recording the backoff state of devices.
+template <typename P>
+struct backoff_program {
+    //! @brief Runs a round.
+    template <typename node_t>
+    void operator()(node_t& node, times_t t) {
+        P{}(node, t);
+        if (node.uid >= backoffs.size()) backoffs.resize(node.uid + 1);
+        backoffs[node.uid] = node.storage(coordination::tags::backoff_log{});
+        ++rounds;
+    }
+};
+
+int main() {
+    // Default parameters, as in the graphical simulations, on a static topology.
+    int tvar = option::var_def<option::tvar>;
+    int hops = option::var_def<option::hops>;
+    int dens = option::var_def<option::dens>;
+    int speed = 0;
+    int side = hops * (2*dens)/(2*dens+1.0) * comm / sqrt(2.0) + 0.5;
+    int devices = dens*side*side/(3.141592653589793*comm*comm) + 0.5;
+    // Construct the plotter object (discarded).
+    option::plot_t p;
+    // The network object type (batch simulator with given options, recording backoffs).
+    using net_t = component::batch_simulator<option::program<backoff_program<coordination::main>>, option::list>::net;
+    // The initialisation values.
+    auto init_v = common::make_tagged_tuple<option::output, option::end_time, option::tvar, option::dens, option::hops, option::speed, option::side, option::devices, option::seed, option::plotter>(
+        nullptr, end, tvar, dens, hops, speed, side, devices, 1, &p
+    );
+    {
+        net_t network{init_v};
+        network.run();
+    }
+    size_t skipped = 0, lost = 0;
+    for (round_backoff const& b : backoffs) {
+        skipped += b.skipped();
+        lost += b.lost();
+    }
+    std::cout << "{\"devices\": " << devices << ", \"rounds\": " << rounds << ", \"planned\": " << rounds + skipped
+              << ", \"lost\": " << lost << "}" << std::endl;
+    bool ok = skipped > 0 and lost == 0;
+    std::cout << (skipped > 0 ? "ok   " : "FAIL ") << "rounds: " << rounds << " of " << rounds + skipped << " planned" << std::endl;
+    std::cout << (lost == 0 ? "ok   " : "FAIL ") << "neighbours lost: " << lost << std::endl;
+    return ok ? 0 : 1;
+}
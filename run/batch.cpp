@@ -7,17 +7,36 @@
 
 #include "lib/process_management.hpp"
 #include "lib/simulation_setup.hpp"
+#include "lib/parallel_batch.hpp"
+#include "lib/result_writer.hpp"
+#include "lib/sweep_manifest.hpp"
 
 using namespace fcpp;
 
+PROFILE_ALLOCATIONS;
+
 //! @brief Number of identical runs to be averaged.
 constexpr int runs = 1000;
 
-int main() {
+//! @brief The plotter type, feeding both the plots and the results file.
+using stream_t = batch::streaming_plotter<option::plot_t>;
+
+//! @brief The plotter shard type, collecting the rows of a single run.
+using shard_t = batch::plot_shard<stream_t>;
+
+int main(int argc, char** argv) {
+    // Number of worker threads (all available cores by default).
+    size_t threads = argc > 1 ? std::stoul(argv[1]) : std::thread::hardware_concurrency();
+    // File collecting the rows of every run as they complete (CSV if ending in .csv).
+    std::string results = argc > 2 ? argv[2] : "plot/batch.fcol";
+    // Optional sharding: `--shard i n` runs the i-th of n disjoint shards, `--merge n` merges n shards into the plots.
+    std::string mode = argc > 3 ? argv[3] : "";
+    size_t shard = mode == "--shard" and argc > 5 ? std::stoul(argv[4]) : 0;
+    size_t shards = mode == "--shard" and argc > 5 ? std::stoul(argv[5]) : mode == "--merge" and argc > 4 ? std::stoul(argv[4]) : 1;
     // Construct the plotter object.
     option::plot_t p;
-    // The component type (batch simulator with given options).
-    using comp_t = component::batch_simulator<option::list>;
+    // The component type (batch simulator with given options, logging into plotter shards).
+    using comp_t = component::batch_simulator<option::plot_type<shard_t>, option::list>;
     // The list of initialisation values to be used for simulations.
     auto init_list = batch::make_tagged_tuple_sequence(
             batch::arithmetic<option::seed>(runs + 1, 40*runs, 1, 1, runs), // 40x random seeds for the default setting
@@ -37,11 +56,29 @@ int main() {
                 double s = common::get<option::side>(x);
                 return d*s*s/(3.141592653589793*comm*comm) + 0.5;
             }),
-            batch::constant<option::output, option::end_time, option::plotter>(nullptr, 50, &p) // reference to the plotter object
+            batch::constant<option::output, option::end_time, option::plotter>(nullptr, 50, (shard_t*)nullptr) // plotter shard (set by each worker)
     );
-    // Runs the given simulations.
-    batch::run(comp_t{}, init_list);
-    // Builds the resulting plots.
+    // Identifies runs across sweeps by their parameters.
+    auto key = [](auto const& x) {
+        return batch::manifest_key(common::get<option::seed>(x), common::get<option::tvar>(x), common::get<option::dens>(x), common::get<option::hops>(x), common::get<option::speed>(x));
+    };
+    if (mode == "--shard") {
+        // Runs a shard of the simulations into its own result file, without plots.
+        batch::resumable_run<option::end_time>(comp_t{}, p, batch::strided_sequence<decltype(init_list)>(init_list, shard, shards), key, batch::shard_path(results, shard), threads);
+        return 0;
+    }
+    // The result files of the shards to be merged (missing runs are simulated).
+    std::vector<std::string> sources;
+    if (mode == "--merge") for (size_t i = 0; i < shards; ++i) sources.push_back(batch::shard_path(results, i));
+    // Runs the given simulations in parallel (skipping those completed by previous sweeps), merging shards into the plotter in sequence order.
+    batch::resumable_run<option::end_time>(comp_t{}, p, init_list, key, results, threads, sources);
+    // Builds the resulting plots (a file for every variant when co-simulating).
+#ifdef COSIM
+    p.for_each([](size_t i, auto& q){
+        std::ofstream("plot/" + option::plot_names[i] + " batch.asy") << plot::file(option::plot_names[i] + " batch", q.build());
+    });
+#else
     std::cout << plot::file("batch", p.build());
+#endif
     return 0;
 }
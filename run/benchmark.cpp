@@ -0,0 +1,61 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file benchmark.cpp
+ * @brief Measures time and heap allocations per round of the aggregate building blocks, printing them as JSON lines.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lib/benchmark.hpp"
+#include "lib/benchmark_setup.hpp"
+
+using namespace fcpp;
+
+FCPP_COUNT_ALLOCATIONS;
+
+//! @brief Parses a comma-separated list of numbers.
+std::vector<size_t> parse_list(std::string const& s) {
+    std::vector<size_t> v;
+    std::stringstream ss(s);
+    std::string x;
+    while (std::getline(ss, x, ',')) v.push_back(std::stoul(x));
+    return v;
+}
+
+int main(int argc, char** argv) {
+    // Numbers of neighbours of every device.
+    std::vector<size_t> neighbours = parse_list(argc > 1 ? argv[1] : "4,16,28,64");
+    // Numbers of processes run by every device (for building blocks handling processes).
+    std::vector<size_t> processes = parse_list(argc > 2 ? argv[2] : "1,8,32");
+    // Number of rounds measured (after the warm-up ones).
+    size_t rounds = argc > 3 ? std::stoul(argv[3]) : 100;
+    // The network object type (batch simulator with given options).
+    using net_t = component::batch_simulator<option::list>::net;
+    for (size_t c = 0; c < coordination::bench_names.size(); ++c)
+        for (size_t n : neighbours)
+            for (size_t p : coordination::bench_spawns(c) ? processes : std::vector<size_t>{0}) {
+                coordination::bench_meter& m = coordination::bench_meter::instance();
+                m = {};
+                // Every device is connected to every other one.
+                auto init_v = common::make_tagged_tuple<option::output, option::end_time, option::devices, option::bench_case, option::bench_procs, option::seed>(
+                    nullptr,
+                    coordination::bench_warmup + rounds - 1,
+                    n + 1,
+                    c,
+                    p,
+                    1
+                );
+                {
+                    net_t network{init_v};
+                    network.run();
+                }
+                std::cout << "{\"case\": \"" << coordination::bench_names[c] << "\", \"neighbours\": " << n << ", \"processes\": " << p
+                          << ", \"rounds\": " << m.rounds << ", \"ns_per_round\": " << m.ns / m.rounds
+                          << ", \"allocs_per_round\": " << double(m.allocations) / m.rounds << "}" << std::endl;
+            }
+    return 0;
+}
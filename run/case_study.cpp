@@ -10,6 +10,8 @@
 
 using namespace fcpp;
 
+PROFILE_ALLOCATIONS;
+
 int main() {
     option::plot_t p;
     std::cout << "/*\n";
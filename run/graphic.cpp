@@ -5,11 +5,15 @@
  * @brief Runs a single execution of the message dispatch case study with a graphical user interface.
  */
 
+#include <fstream>
+
 #include "lib/process_management.hpp"
 #include "lib/simulation_setup.hpp"
 
 using namespace fcpp;
 
+PROFILE_ALLOCATIONS;
+
 int main() {
     // Construct the plotter object.
     option::plot_t p;
@@ -43,6 +47,12 @@ int main() {
     }
     // Plot simulation results.
     std::cout << "*/\n";
+#ifdef COSIM
+    p.for_each([](size_t i, auto& q){
+        std::ofstream("plot/" + option::plot_names[i] + " graphic.asy") << plot::file(option::plot_names[i] + " graphic", q.build());
+    });
+#else
     std::cout << plot::file("graphic", p.build());
+#endif
     return 0;
 }
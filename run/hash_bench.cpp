@@ -0,0 +1,85 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file hash_bench.cpp
+ * @brief Compares insertion and lookup times of the containers used for messages and device sets.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+#include "lib/generals.hpp"
+#include "lib/roaring_set.hpp"
+
+using namespace fcpp;
+
+//! @brief Hasher for messages as formerly computed by `message::hash`, packing times and UIDs into bit fields.
+struct packing_hash {
+    size_t operator()(message const& m) const {
+        constexpr size_t offs = sizeof(size_t)*CHAR_BIT/3;
+        return (size_t(m.time) << (2*offs)) | (size_t(m.from) << (offs)) | size_t(m.to);
+    }
+};
+
+//! @brief Identity hasher for devices, as the standard one.
+using identity_hash = std::hash<device_t>;
+
+//! @brief Number of repetitions of every measure.
+constexpr size_t reps = 20;
+
+//! @brief Average nanoseconds per element of a function applied to a sequence of keys.
+template <typename F, typename K>
+double time_ns(F&& f, std::vector<K> const& keys) {
+    auto start = std::chrono::high_resolution_clock::now();
+    f(keys);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / keys.size();
+}
+
+//! @brief Prints insertion and lookup times of a container type for given present and absent keys.
+template <typename C, typename K>
+void measure(std::string name, std::vector<K> const& keys, std::vector<K> const& misses) {
+    double ins = 0, hit = 0, miss = 0;
+    size_t found = 0;
+    for (size_t r = 0; r < reps; ++r) {
+        C c;
+        ins  += time_ns([&](auto const& v){ for (K const& k : v) c.insert(k); }, keys);
+        hit  += time_ns([&](auto const& v){ for (K const& k : v) found += c.count(k); }, keys);
+        miss += time_ns([&](auto const& v){ for (K const& k : v) found += c.count(k); }, misses);
+    }
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(8) << keys.size()
+              << std::fixed << std::setprecision(2)
+              << std::setw(10) << ins / reps << std::setw(10) << hit / reps << std::setw(10) << miss / reps
+              << (found == reps * keys.size() ? "" : "  (mismatch)") << std::endl;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    std::cout << std::left << std::setw(36) << "# container" << std::right << std::setw(8) << "size"
+              << std::setw(10) << "insert" << std::setw(10) << "hit" << std::setw(10) << "miss" << "  (ns/op)" << std::endl;
+    for (size_t n : {16, 256, 4096, 65536}) {
+        // messages with sub-integer times between few devices with large UIDs
+        std::vector<message> msgs, msg_misses;
+        std::uniform_real_distribution<real_t> time_d(10, 12);
+        std::uniform_int_distribution<device_t> dev_d(1000000, 1000064);
+        for (size_t i = 0; i < 2*n; ++i)
+            (i < n ? msgs : msg_misses).emplace_back(dev_d(gen), dev_d(gen), time_d(gen), real_t(i));
+        measure<std::unordered_set<message, packing_hash>>("unordered_set<message> (packing)", msgs, msg_misses);
+        measure<std::unordered_set<message>>("unordered_set<message> (mixing)", msgs, msg_misses);
+        measure<flat_hash_set<message>>("flat_hash_set<message>", msgs, msg_misses);
+        // devices in a range of UIDs
+        std::vector<device_t> devs, dev_misses;
+        for (size_t i = 0; i < 2*n; ++i) (i % 2 ? dev_misses : devs).push_back(device_t(i));
+        std::shuffle(devs.begin(), devs.end(), gen);
+        measure<std::unordered_set<device_t, identity_hash>>("unordered_set<device_t>", devs, dev_misses);
+        measure<flat_hash_set<device_t>>("flat_hash_set<device_t>", devs, dev_misses);
+        measure<roaring_set<device_t>>("roaring_set<device_t>", devs, dev_misses);
+    }
+    return 0;
+}
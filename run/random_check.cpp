@@ -0,0 +1,124 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file random_check.cpp
+ * @brief Checks that the counter-based random fields follow the same distributions as the standard generators.
+ *
+ * For every distribution, draws from `field_random` are compared with draws from the standard
+ * library through a two-sample Kolmogorov-Smirnov test, both for whole fields drawn from fresh
+ * keys (as in `fast_rand_hood`) and for single values drawn from consecutive keys (as in bundles).
+ * Exits with a failure if some statistic exceeds the critical value at the 1% significance level.
+ * The nanoseconds taken to draw a field through `field_random` and through the standard generators
+ * (as in `rand_hood`) are also printed, for fields of the size of the large simulation neighbourhoods.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "lib/field_random.hpp"
+
+using namespace fcpp;
+
+//! @brief Number of draws compared for every distribution.
+constexpr size_t draws = 1000000;
+
+//! @brief Size of the fields drawn from the same key.
+constexpr size_t field_size = 11;
+
+//! @brief Size of the fields timed (28 neighbours and the device itself).
+constexpr size_t timed_size = 29;
+
+//! @brief Number of fields drawn in a timing repetition.
+constexpr size_t timed_fields = 100000;
+
+//! @brief Coefficient of the critical value of the two-sample test at the 1% significance level.
+constexpr double ks_coeff = 1.628;
+
+//! @brief The two-sample Kolmogorov-Smirnov statistic (sorting the samples).
+double ks_statistic(std::vector<double>& x, std::vector<double>& y) {
+    std::sort(x.begin(), x.end());
+    std::sort(y.begin(), y.end());
+    double d = 0;
+    size_t i = 0, j = 0;
+    while (i < x.size() and j < y.size()) {
+        double v = std::min(x[i], y[j]);
+        while (i < x.size() and x[i] <= v) ++i;
+        while (j < y.size() and y[j] <= v) ++j;
+        d = std::max(d, std::abs(double(i) / x.size() - double(j) / y.size()));
+    }
+    return d;
+}
+
+//! @brief Compares the draws of a distribution, printing the outcome and returning whether it passed.
+template <typename D>
+bool check(std::string name, D d, bool fields, std::mt19937_64& gen) {
+    std::vector<double> fast(draws), slow(draws);
+    uint64_t key = gen();
+    for (size_t i = 0; i < draws; i += field_size) {
+        size_t n = std::min(field_size, draws - i);
+        if (fields) field_random::fill(fast.data() + i, n, gen(), d);
+        else for (size_t j = 0; j < n; ++j) field_random::fill(fast.data() + i + j, 1, key + i + j, d);
+    }
+    for (double& x : slow) x = d(gen);
+    double stat = ks_statistic(fast, slow);
+    double crit = ks_coeff * std::sqrt(2.0 / draws);
+    std::cout << std::left << std::setw(36) << name + (fields ? " (fields)" : " (single)") << std::right
+              << std::fixed << std::setprecision(5) << std::setw(10) << stat << std::setw(10) << crit
+              << (stat <= crit ? "" : "  (mismatch)") << std::endl;
+    return stat <= crit;
+}
+
+//! @brief The least nanoseconds per call of a function drawing a field, over a few repetitions.
+template <typename F>
+double best_time(F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < 5; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < timed_fields; ++k) f(k);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / timed_fields);
+    }
+    return best;
+}
+
+//! @brief Prints the nanoseconds taken to draw a field of a distribution, through counters and through the generator.
+template <typename D>
+void timing(std::string name, D d, std::mt19937_64& gen) {
+    std::vector<double> x(timed_size);
+    // stores the first value drawn, so that draws are not optimised away
+    static volatile double sink;
+    double fast = best_time([&](size_t k){
+        field_random::fill(x.data(), x.size(), k * field_random::step, d);
+        sink = x[0];
+    });
+    double slow = best_time([&](size_t){
+        for (double& y : x) y = d(gen);
+        sink = x[0];
+    });
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << fast << std::setw(10) << slow << std::endl;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    std::cout << std::left << std::setw(36) << "# distribution" << std::right
+              << std::setw(10) << "D" << std::setw(10) << "critical" << std::endl;
+    bool ok = true;
+    for (bool fields : {true, false}) {
+        ok &= check("uniform(2,5)", std::uniform_real_distribution<double>(2, 5), fields, gen);
+        ok &= check("weibull(3.7,1.1)", std::weibull_distribution<double>(3.7, 1.1), fields, gen);
+        ok &= check("weibull(0.8,2)", std::weibull_distribution<double>(0.8, 2), fields, gen);
+        ok &= check("exponential(0.5)", std::exponential_distribution<double>(0.5), fields, gen);
+    }
+    std::cout << std::left << std::setw(36) << "# ns per field of " + std::to_string(timed_size) << std::right
+              << std::setw(10) << "counters" << std::setw(10) << "standard" << std::endl;
+    timing("uniform(2,5)", std::uniform_real_distribution<double>(2, 5), gen);
+    timing("weibull(3.7,1.1)", std::weibull_distribution<double>(3.7, 1.1), gen);
+    timing("exponential(0.5)", std::exponential_distribution<double>(0.5), gen);
+    return ok ? 0 : 1;
+}
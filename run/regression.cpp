@@ -0,0 +1,108 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file regression.cpp
+ * @brief Runs a fixed seeded scenario headless, comparing its throughput against a baseline.
+ *
+ * The scenario is selected by the compilation flags: `CASE_STUDY` for the case study, otherwise
+ * the process management simulation with the `NOTREE` (sphere), `NOSPHERE` (tree), `BLOOM` and `COSIM` flags.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#ifdef CASE_STUDY
+#include "lib/case_study.hpp"
+#include "lib/case_study_setup.hpp"
+#else
+#include "lib/process_management.hpp"
+#include "lib/simulation_setup.hpp"
+#endif
+#include "lib/regression.hpp"
+
+using namespace fcpp;
+
+PROFILE_ALLOCATIONS;
+
+//! @brief The name of the scenario.
+#if defined(CASE_STUDY)
+std::string const scenario = "case_study";
+#elif defined(COSIM) and defined(NOSPHERE)
+std::string const scenario = "cosim_tree";
+#elif defined(COSIM)
+std::string const scenario = "cosim";
+#elif defined(BLOOM)
+std::string const scenario = "bloom";
+#elif defined(ROARING)
+std::string const scenario = "roaring";
+#elif defined(NOTREE)
+std::string const scenario = "sphere";
+#elif defined(NOSPHERE)
+std::string const scenario = "tree";
+#else
+std::string const scenario = "full";
+#endif
+
+//! @brief The end of simulated time.
+constexpr int end = 100;
+
+int main(int argc, char** argv) {
+    // The baseline file, and whether to replace the baseline of the scenario instead of comparing.
+    std::string path = "run/regression.json";
+    bool update = std::getenv("REGRESSION_UPDATE") != nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--update") update = true;
+        else path = argv[i];
+    }
+    // Default parameters, as in the graphical simulations.
+    int tvar = option::var_def<option::tvar>;
+    int hops = option::var_def<option::hops>;
+    int dens = option::var_def<option::dens>;
+    int speed = option::var_def<option::speed>;
+    int side = hops * (2*dens)/(2*dens+1.0) * comm / sqrt(2.0) + 0.5;
+    int devices = dens*side*side/(3.141592653589793*comm*comm) + 0.5;
+    // Construct the plotter object (discarded).
+    option::plot_t p;
+    // The network object type (batch simulator with given options, counting rounds and bytes).
+    using net_t = component::batch_simulator<option::program<coordination::counted_program<coordination::main>>, option::list>::net;
+    // The initialisation values.
+#ifdef CASE_STUDY
+    double infospeed = (0.08*dens - 0.7) * speed * 0.01 + 0.075*dens*dens - 1.6*dens + 11;
+    auto init_v = common::make_tagged_tuple<option::output, option::end_time, option::tvar, option::dens, option::hops, option::speed, option::side, option::devices, option::infospeed, option::seed, option::plotter>(
+        nullptr, end, tvar, dens, hops, speed, side, devices, infospeed, 1, &p
+    );
+#else
+    auto init_v = common::make_tagged_tuple<option::output, option::end_time, option::tvar, option::dens, option::hops, option::speed, option::side, option::devices, option::seed, option::plotter>(
+        nullptr, end, tvar, dens, hops, speed, side, devices, 1, &p
+    );
+#endif
+    auto start = std::chrono::steady_clock::now();
+    {
+        net_t network{init_v};
+        network.run();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    coordination::work_counter& c = coordination::work_counter::instance();
+    // Events processed by devices: rounds, and neighbour exports delivered to them.
+    double events = c.rounds + c.exports;
+    regression_baseline::measures_t m = {
+        {"wall_s",          wall},
+        {"rounds",          double(c.rounds)},
+        {"rounds_per_s",    c.rounds / wall},
+        {"events",          events},
+        {"events_per_s",    events / wall},
+        {"sim_time_per_s",  end / wall},
+        {"peak_rss_kb",     double(peak_rss_kb())},
+        {"bytes",           double(c.bytes)}
+    };
+    std::cout << "{\"scenario\": \"" << scenario << "\"";
+    for (auto const& x : m) std::cout << ", \"" << x.first << "\": " << x.second;
+    std::cout << "}" << std::endl;
+    regression_baseline baseline(path);
+    if (update) {
+        baseline.update(scenario, m);
+        return 0;
+    }
+    return baseline.compare(scenario, m, std::cout) ? 0 : 1;
+}
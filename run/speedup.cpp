@@ -0,0 +1,56 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file speedup.cpp
+ * @brief Runs a single large simulation of the process management program headless, timing its rounds.
+ *
+ * The network diameter and density are given (default 24 hops with density 28), and the area side
+ * and number of devices are derived from them as in the batch runs. Meant to be compiled with the
+ * `PARALLEL` flag, or with the `SLOTS` flag for the serial execution of the same schedule.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "lib/process_management.hpp"
+#include "lib/simulation_setup.hpp"
+#include "lib/regression.hpp"
+
+using namespace fcpp;
+
+PROFILE_ALLOCATIONS;
+
+//! @brief The end of simulated time.
+constexpr int end = 60;
+
+int main(int argc, char** argv) {
+    // Default parameters, as in the graphical simulations, with the given diameter and density.
+    int tvar = option::var_def<option::tvar>;
+    int hops = argc > 1 ? std::stoi(argv[1]) : 24;
+    int dens = argc > 2 ? std::stoi(argv[2]) : 28;
+    int speed = option::var_def<option::speed>;
+    int side = hops * (2*dens)/(2*dens+1.0) * comm / sqrt(2.0) + 0.5;
+    int devices = dens*side*side/(3.141592653589793*comm*comm) + 0.5;
+    // Construct the plotter object (discarded).
+    option::plot_t p;
+    // The network object type (batch simulator with given options, counting rounds and bytes).
+    using net_t = component::batch_simulator<option::program<coordination::counted_program<coordination::main>>, option::list>::net;
+    // The initialisation values.
+    auto init_v = common::make_tagged_tuple<option::output, option::end_time, option::tvar, option::dens, option::hops, option::speed, option::side, option::devices, option::seed, option::plotter>(
+        nullptr, end, tvar, dens, hops, speed, side, devices, 1, &p
+    );
+    auto start = std::chrono::steady_clock::now();
+    {
+        net_t network{init_v};
+        network.run();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    coordination::work_counter& c = coordination::work_counter::instance();
+    std::cout << "{\"devices\": " << devices << ", \"side\": " << side << ", \"hops\": " << hops << ", \"dens\": " << dens
+              << ", \"wall_s\": " << wall << ", \"sim_time_per_s\": " << end / wall
+              << ", \"rounds\": " << c.rounds << ", \"rounds_per_s\": " << c.rounds / wall
+              << ", \"bytes\": " << c.bytes << ", \"peak_rss_kb\": " << peak_rss_kb() << "}" << std::endl;
+    return 0;
+}